@@ -14,33 +14,173 @@
 
 #include "stdint.h"
 #include "ws2812b.h"
+#include "color.h"
+#include "profiles.h"
+#include "compositor.h"
+#include "timeline.h"
+#include "clock.h"
+#include "canvas.h"
+#include "coro.h"
+
+// Every effect keeps its state in a context struct that the caller owns (LumaFSM keeps one EffectContext) and draws
+// into the layers it is given - the layers, palette, output stage and clocks below them are still one per process
+
+// ==================== Sub-pixel Drawing ====================
+// Positions are 8.8 fixed point pixels (column, row) -> the upper byte is the pixel, the lower byte how far towards the next one
+#define SUBPIXEL        256                 // one pixel in sub-pixel units
+#define TO_SUBPIXEL(p)  ((int16_t)((p) * SUBPIXEL))
+
+void drawSoftPoint(LayerId target, int16_t x, int16_t y, const Rgb16 &color); // Splats a point over the 2x2 pixels around it (bilinear, additive)
 
 // ==================== Screensaver Animation ====================
 enum SaverPhase {   // States of the moving orb
     MOVE,           // normal motion
-    VIBRATE,        // anticipation - when button pressed    
-    EXPLODE         // explosion
+    HIT             // vibrate (anticipation) + explosion - timeline driven
+};
+
+#define SAVER_MARGIN    2                   // pixels the camera keeps between the orb and the edges of the matrix
+
+struct Orb {                    // The drifting screensaver orb, roams the whole canvas world
+    int16_t x, y;               // position in the world, 8.8 sub-pixel
+    int16_t vx, vy;             // velocity, 8.8 pixels per second
+    Rgb16 color;                // pixel orb color
+    ClockMs lastStep;           // time of the last move
+};
+
+struct OrbHit {                 // One orb hit choreography
+    TimelinePlayer player;      // plays HIT_TIMELINE
+    ClockMs start;              // when the orb was hit
+    int16_t x, y;               // explosion origin on the matrix, 8.8 sub-pixel
+    Rgb16 orbColor;             // color of the orb while it vibrates
+    uint16_t explosionHue;      // color of the explosion
 };
 
-void startPixelExplosion(int row, int col); // Starts pixel explosion
-bool isExplosionDone();                     // checks if explosion is active
-void updatePixelExplosion();                // updating explosion animation
+void Orb_Init(Orb &orb, CanvasView &view);      // Orb starts at the left edge drifting right, camera in the top left corner of the world
+void Orb_Respawn(Orb &orb, const CanvasView &view); // Random position in view, direction and color (after an explosion)
+void Orb_Update(Orb &orb, CanvasView &view, LayerId target);   // Moves the orb by the time since the last call, pans the camera after it and draws it, every tick
+void Saver_BuildWorld();                        // Scatters the starfield the orb drifts over into the canvas - once, from setup()
+
+void startOrbHit(OrbHit &hit, const Orb &orb, const CanvasView &view);  // Starts the vibrate + explosion choreography where the orb is on the matrix
+bool isOrbHitDone(const OrbHit &hit);           // checks if the hit choreography finished
+void updateOrbHit(OrbHit &hit, LayerId target); // updating vibrate / explosion animation
 
 // ==================== Menu Preview - Color flood & Falling pixel ====================
-void drawMenu_ColorFlood();     // Menu Preview Animation for Color Flood 
-void drawMenu_FallingPixel();   // Menu Preview Animation for Falling Pixel
+#if LUMA_FEATURE_COLOR_FLOOD
+struct FloodPreview {           // Menu preview of Color Flood
+    ClockMs lastUpdate;         // when the last frame was drawn
+    int8_t radius;              // radius of expanding color flood
+    int8_t cx, cy;              // center of ripple
+    uint16_t baseHue;           // base color
+};
+void drawMenu_ColorFlood(FloodPreview &preview, LayerId target);     // Menu Preview Animation for Color Flood 
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+struct FallPreview {            // Menu preview of Falling Pixel
+    ClockMs lastUpdate;         // when the last frame was drawn
+    ClockMs gravityPauseUntil;  // until what time the animation should pause
+    int8_t row, col;            // falling pixel position
+    Rgb16 color;                // falling pixel color
+};
+void drawMenu_FallingPixel(FallPreview &preview, LayerId target);   // Menu Preview Animation for Falling Pixel
+#endif
 
+#if LUMA_FEATURE_COLOR_FLOOD
 // ******************** Color Fade Interaction ******************** 
-void ColorFlood_Init();         // Initializes Color Flood Interaction
-void ColorFlood_StartNew();     // Spawns a new Color Flood 
-void ColorFlood_Update();       // Animation Engine for the Color Flood
+#define MAX_FLOODS 5    // Limits the no: of simultaneous floods to prevent unexpected crashes/resets due to unknown memory access
+
+struct ColorFlood {     // Defines one color flood  
+    int8_t cx;          // center of flood coordinates
+    int8_t cy;          // center of flood coordinates
+    int8_t radius;      // how far the flood expands
+    bool active;        // is the flood active or not
+    uint16_t baseHue;   // base color of the flood
+};
+
+struct ColorFloodContext {
+    ColorFlood floods[MAX_FLOODS];  // pool of animation instances
+    ClockMs lastUpdate;             // frame rate control for the flood
+};
+
+void ColorFlood_Init(ColorFloodContext &flood, LayerId target);      // Initializes Color Flood Interaction
+void ColorFlood_StartNew(ColorFloodContext &flood);                  // Spawns a new Color Flood 
+void ColorFlood_Update(ColorFloodContext &flood, LayerId target);    // Animation Engine for the Color Flood
+void ColorFlood_Step(ColorFloodContext &flood, LayerId target);      // One flood step, no frame rate control (benchmarks)
+#endif
 
+#define FALL_PACK_MAX (WIDTH / 2 + NUM_LEDS)    // packed Falling Pixel board: column heights + one hue per settled pixel
+
+#if LUMA_FEATURE_FALLING_PIXEL
 // ******************** Faliing Pixels Interaction ******************** 
-void FallingPixel_Init();               // Initializes Falling Pixel Interaction
-void FallingPixel_Spawn(uint8_t count); // Spawns the pixels according to the button press
-void FallingPixel_Update();             // Animation Engine for the Falling Pixel 
-bool FallingPixel_IsFull();             // Checks if the column is full
-void FallingPixel_Explosion();          // Hihg Level Animation End sequence
+#define MAX_FALLING 8   // max simultaneous falling pixels
+
+struct FallingPixel {   // Defines one falling pixel
+    bool active;        // if the pixel currently falling
+    int8_t x;           // column
+    int8_t y;           // row
+    uint8_t hue;        // kept in the grid once it settles
+    Rgb16 color;        // linear light color
+};
+
+struct FallFinale {      // The end sequence once the board is full - a coroutine, one step per frame
+    Coro coro;          // where the sequence is
+    ClockMs sparkleEnd; // end of the anticipation phase
+    uint8_t phase;      // sparkle shimmer phase
+    uint8_t pauseMs;    // pause after each beam, shrinks as the board empties
+    uint8_t step;       // closing fade step
+    int8_t col, row;    // column being beamed out, row the beam has reached
+};
+
+struct FallingPixelContext {
+    uint8_t grid[HEIGHT][WIDTH];        // settled pixels, stores the hue of each (see settledColor) - occupancy is columnHeight
+    uint8_t columnHeight[WIDTH];        // for each column how many pixels are stacked
+    FallingPixel falling[MAX_FALLING];  // fixed falling limit no dynamic allocation
+    ClockMs lastFall;                   // used for frame timing
+    FallFinale finale;                  // end sequence, runs instead of the physics while it plays
+};
+
+void FallingPixel_Init(FallingPixelContext &fall, LayerId trail, LayerId settled);      // Initializes Falling Pixel Interaction
+void FallingPixel_Spawn(FallingPixelContext &fall, uint8_t count);                      // Spawns the pixels according to the button press
+void FallingPixel_Update(FallingPixelContext &fall, LayerId trail, LayerId settled);    // Animation Engine for the Falling Pixel 
+bool FallingPixel_IsFull(const FallingPixelContext &fall);                              // Checks if the column is full
+void FallingPixel_Explosion(FallingPixelContext &fall, LayerId trail);                 // Starts the end sequence, FallingPixel_Update plays it
+bool FallingPixel_InFinale(const FallingPixelContext &fall);                            // true while the end sequence plays
+
+uint8_t FallingPixel_Pack(const FallingPixelContext &fall, uint8_t *out);  // Packs the settled board into FALL_PACK_MAX bytes (snapshots)
+bool FallingPixel_Unpack(FallingPixelContext &fall, const uint8_t *in, uint8_t length, LayerId trail, LayerId settled); // Restores a packed board, false if it is invalid
+#endif
+
+#if LUMA_FEATURE_AURORA
+// ******************** Aurora Ambient Mode ******************** 
+struct AuroraContext {
+    uint16_t hue;               // start of the hue band (green - cyan - blue)
+    ClockMs previewUpdate;      // frame rate control of the menu preview
+};
+
+void Aurora_Init(AuroraContext &aurora);                            // Initializes Aurora ambient mode
+void Aurora_NextHue(AuroraContext &aurora);                         // Shifts the aurora to the next hue band
+void Aurora_Update(AuroraContext &aurora);                          // Animation Engine for the Aurora (noise field, LAYER_PALETTE)
+void drawMenu_Aurora(AuroraContext &aurora, LayerId target);        // Menu Preview Animation for Aurora
+#endif
+
+// ==================== Effect Context ====================
+struct EffectContext {      // All animation state of one device
+    Orb orb;
+    OrbHit hit;
+    CanvasView view;        // camera of the screensaver world
+#if LUMA_FEATURE_COLOR_FLOOD
+    FloodPreview floodPreview;
+    ColorFloodContext flood;
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    FallPreview fallPreview;
+    FallingPixelContext fall;
+#endif
+#if LUMA_FEATURE_AURORA
+    AuroraContext aurora;
+#endif
+};
+
+void Effects_Init(EffectContext &effects);  // Starting values of every effect (orb & its world, random preview origins, aurora hue band)
 
 
-#endif
\ No newline at end of file
+#endif
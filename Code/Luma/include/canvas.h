@@ -0,0 +1,63 @@
+/**
+ * @file canvas.h
+ * @author sarvesh
+ * @brief Virtual world canvas with a scrolling viewport
+ * A CANVAS_WIDTH x CANVAS_HEIGHT world of 4-bit color indices (two cells per byte) that is larger than the
+ * matrix. A CanvasView is an 8x8 window into it at a sub-pixel position, Canvas_Render samples only the cells
+ * under the window into a layer - so the cost follows the viewport, never the size of the world.
+ * The world is split into CANVAS_TILE x CANVAS_TILE tiles : a write only marks its tile, empty tiles are skipped
+ * while sampling and the view remembers where it was drawn, so a window that did not move over tiles that did not
+ * change is not drawn again.
+ * There is one world per firmware (file statics, like the palette) - devices share it and each moves its own view
+ * @version 1.0
+ * @date 2026-3-11
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include "stdint.h"
+#include "ws2812b.h"
+#include "color.h"
+#include "compositor.h"
+
+// ==================== World ====================
+#ifndef CANVAS_WIDTH
+#define CANVAS_WIDTH 64         // world cells, at most 127 so 8.8 positions fit an int16_t
+#endif
+#ifndef CANVAS_HEIGHT
+#define CANVAS_HEIGHT 64
+#endif
+#define CANVAS_TILE 8           // tile edge in cells
+#define CANVAS_TILES_X (CANVAS_WIDTH / CANVAS_TILE)
+#define CANVAS_TILES_Y (CANVAS_HEIGHT / CANVAS_TILE)
+#define CANVAS_COLORS 16        // 4-bit cells, index 0 is transparent
+
+static_assert(CANVAS_WIDTH % CANVAS_TILE == 0 && CANVAS_HEIGHT % CANVAS_TILE == 0, "the world must be whole tiles");
+static_assert(CANVAS_TILES_X * CANVAS_TILES_Y <= 64, "tile masks are 64 bits");
+static_assert(CANVAS_WIDTH >= WIDTH && CANVAS_HEIGHT >= HEIGHT && CANVAS_WIDTH <= 127 && CANVAS_HEIGHT <= 127, "world must cover the matrix and fit 8.8 positions");
+
+void Canvas_Clear();                                    // Every cell to index 0
+void Canvas_SetColor(uint8_t index, const Rgb16 &color);    // Color of a cell index (linear light)
+void Canvas_Set(int x, int y, uint8_t index);          // Writes one cell, outside the world is ignored - O(1), only marks its tile
+uint8_t Canvas_Get(int x, int y);                       // Reads one cell, 0 outside the world
+
+// ==================== Viewport ====================
+struct CanvasView {         // An 8x8 window into the world
+    int16_t x, y;           // top left corner in the world, 8.8 sub-pixel
+    int16_t shownX, shownY; // corner of the window drawn into the layer last time
+    bool shown;             // the layer holds a window of this view
+};
+
+#define TO_CANVAS(p) ((int16_t)((p) * 256))                     // whole cells -> 8.8, same units as SUBPIXEL
+#define CANVAS_VIEW_MAX_X TO_CANVAS(CANVAS_WIDTH - WIDTH)       // last corner that keeps the window inside the world
+#define CANVAS_VIEW_MAX_Y TO_CANVAS(CANVAS_HEIGHT - HEIGHT)
+
+void CanvasView_Init(CanvasView &view, int16_t x, int16_t y);      // Places the window, nothing is drawn yet
+void CanvasView_MoveTo(CanvasView &view, int16_t x, int16_t y);    // Moves the window, kept inside the world
+void CanvasView_Follow(CanvasView &view, int16_t x, int16_t y, uint8_t margin);   // Pans just enough to keep a world point margin pixels off the edges
+bool Canvas_Render(CanvasView &view, LayerId target);  // Draws the window into the layer if it moved or its tiles changed, true if drawn
+
+#endif
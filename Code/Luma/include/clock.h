@@ -0,0 +1,47 @@
+/**
+ * @file clock.h
+ * @author sarvesh
+ * @brief Virtual time base
+ * 64-bit monotonic millisecond clocks that never wrap. The 32-bit millis() source is only ever read as a
+ * delta, so its 49 day wraparound is invisible to the effects. There is one clock per FSM state - the
+ * FSM selects the clock of the current state and effects read it with Clock_Now(), so a state can be
+ * paused or slowed down / sped up without the effects knowing
+ * @version 1.0
+ * @date 2026-3-2
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include "stdint.h"
+
+typedef uint64_t ClockMs;   // milliseconds, 64-bit -> no wraparound in the lifetime of the device
+
+// ==================== Configuration ====================
+#define CLOCK_COUNT         8       // one per LumaState, ids are the state values
+#define CLOCK_SCALE_ONE     256     // 8.8 fixed point time scale -> real time
+
+#ifndef LUMA_CLOCK_START_MS
+#define LUMA_CLOCK_START_MS 0       // offset of the 32-bit source, e.g. 0xFFFF0000 -> millis() wraps after ~65s
+#endif
+
+// ==================== Time ====================
+ClockMs Clock_Now();                // Time of the selected clock, what every effect animates with
+ClockMs Clock_Uptime();             // Unscaled time since boot, never paused (input timing, flash write policy)
+void Clock_Select(uint8_t id);      // Selects the clock returned by Clock_Now() - the FSM selects the current state's
+void Clock_Delay(uint32_t ms);      // Waits and advances every clock - replaces delay()
+#ifdef LUMA_STRESS
+void Clock_Skip(uint32_t ms);       // Advances every clock without waiting (stress runs)
+void Clock_Reset();                 // Every clock back to 0 as after power on (stress runs)
+#endif
+
+// ==================== Per Clock Control ====================
+void Clock_Pause(uint8_t id);                   // Freezes a clock, effects that use it stop moving
+void Clock_Resume(uint8_t id);
+void Clock_SetScale(uint8_t id, uint16_t scale);// Time scale in CLOCK_SCALE_ONE units (128 -> half speed)
+
+void Clock_Command(const char *args);   // Console command "clock" - status | pause | resume | scale <percent>, on the selected clock
+
+#endif
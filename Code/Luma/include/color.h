@@ -0,0 +1,49 @@
+/**
+ * @file color.h
+ * @author sarvesh
+ * @brief Linear light working color space
+ * Effects, layers and the palette keep colors as 16-bit linear light per channel, so fades, blends
+ * and trails scale real light output instead of gamma encoded values. Colors are decoded once when an
+ * effect picks them, and encoded once for the LEDs by the output stage (output.h)
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef COLOR_H
+#define COLOR_H
+
+#include "stdint.h"
+
+// ==================== Linear Color ====================
+struct Rgb16 {          // linear light color, 0 -> off, 65535 -> full drive | black is transparent in every layer
+    uint16_t r, g, b;
+};
+
+#define RGB16_BLACK Rgb16{ 0, 0, 0 }
+
+/**
+ * @brief true if the color is black (transparent in the compositor)
+ *
+ */
+static inline bool Color_IsBlack(const Rgb16 &c) {
+    return !(c.r | c.g | c.b);
+}
+
+/**
+ * @brief Scales all three channels by scale / 256 - linear light, so this is a true fade
+ *
+ */
+static inline Rgb16 Color_Scale(const Rgb16 &c, uint8_t scale) {
+    return Rgb16{ (uint16_t)(((uint32_t)c.r * scale) >> 8),
+                  (uint16_t)(((uint32_t)c.g * scale) >> 8),
+                  (uint16_t)(((uint32_t)c.b * scale) >> 8) };
+}
+
+// ==================== Color Pickers ====================
+uint16_t Color_Linearize(uint8_t v);                        // Perceptual 0-255 channel -> linear 0-65535
+Rgb16 Color_HSV(uint16_t hue, uint8_t sat, uint8_t val);    // Perceptual HSV (same arguments as ColorHSV) -> linear light
+Rgb16 Color_Hex(uint32_t rgb);                              // Perceptual packed 0xRRGGBB -> linear light
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file compositor.h
+ * @author sarvesh
+ * @brief Layer compositor
+ * Every effect draws into its own layers, and one composite pass per frame blends the layers of
+ * the active state into the matrix so each LED is written exactly once per frame
+ * @version 1.0
+ * @date 2026-2-6
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "stdint.h"
+#include "ws2812b.h"
+#include "color.h"
+#include "profiles.h"
+
+// ==================== Blend Modes ====================
+// Colors are linear light (color.h) and black is always transparent, so a layer only affects the pixels it actually lit
+enum BlendMode {
+    BLEND_REPLACE,      // layer pixel replaces what is below
+    BLEND_ADD,          // per channel add, saturates at full drive
+    BLEND_MAX,          // per channel max -> overlapping lights never darken each other
+    BLEND_ALPHA         // mix with what is below using the layer alpha
+};
+
+// ==================== Layers ====================
+// Composite order is bottom to top in the order below, layers of interactions outside the build profile do not exist
+enum LayerId {
+    LAYER_PALETTE,          // palette indexed framebuffer (boot bars, aurora) - no storage of its own
+#if LUMA_FEATURE_COLOR_FLOOD
+    LAYER_FLOOD,            // color flood rings - fading trail
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    LAYER_FALL_TRAIL,       // falling pixels and their trails
+    LAYER_FALL_SETTLED,     // settled falling pixel stacks - persistent
+#endif
+#if LUMA_FEATURE_COLOR_FLOOD
+    LAYER_MENU_FLOOD,       // color flood menu preview
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    LAYER_MENU_FALL,        // falling pixel menu preview
+#endif
+#if LUMA_FEATURE_SCRIPT
+    LAYER_SCRIPT,           // bytecode program output - mode & menu preview
+#endif
+#if LUMA_FEATURE_AURORA
+    LAYER_MENU_AURORA,      // aurora menu preview
+#endif
+    LAYER_WORLD,            // window into the virtual canvas (screensaver starfield) - redrawn only when it pans or changes
+    LAYER_SAVER,            // screensaver orb, vibrate & explosion sparks
+    LAYER_TEXT,             // scrolling labels drawn over everything
+    LAYER_COUNT
+};
+
+#define LAYER_BIT(id) ((uint16_t)1 << (id))    // layer masks select which layers take part in a composite
+
+void Layer_BeginFrame(LayerId id);                      // Applies the layer persistence before an effect draws its next step
+void Layer_Clear(LayerId id);                           // Clears the layer to transparent
+void Layer_Fade(LayerId id, uint8_t scale);            // Scales the whole layer by scale / 256
+void Layer_SetPersistence(LayerId id, uint8_t persist);    // What Layer_BeginFrame does : 0 -> clear, 255 -> keep, else fade to persist / 256
+void Layer_SetPixel(LayerId id, int idx, const Rgb16 &color);  // Draws one pixel into the layer
+Rgb16 Layer_GetPixel(LayerId id, int idx);              // Reads one pixel from the layer
+
+// ==================== Render Targets ====================
+// Offscreen frames for transitions - the pool size is fixed at build time so nothing is allocated at runtime
+#ifndef RENDER_TARGET_POOL
+#define RENDER_TARGET_POOL 2    // outgoing + incoming frame of a crossfade
+#endif
+
+struct RenderTarget {
+    Rgb16 pixels[NUM_LEDS];     // linear light, same layout as the matrix
+    bool inUse;                 // owned by someone
+};
+
+RenderTarget *RenderTarget_Acquire();               // Takes a free target from the pool, nullptr if the pool is empty
+void RenderTarget_Release(RenderTarget *target);    // Gives a target back to the pool
+
+// ==================== Compositor ====================
+uint16_t Compositor_Present(uint16_t layerMask);                    // Blends the selected layers and shows the frame through the output stage, returns the layers that changed
+void Compositor_Resolve(uint16_t layerMask, RenderTarget &target);  // Same composite pass but into an offscreen frame
+void Compositor_PresentBlend(const RenderTarget &from, const RenderTarget &to, uint8_t amount); // Crossfades two frames into the matrix
+void Compositor_ResolveBlend(RenderTarget &from, const RenderTarget &to, uint8_t amount);      // Same blend but into from (interrupted crossfade)
+void Compositor_Reset();            // Clears every layer and forgets the last composite (stress runs)
+
+#endif
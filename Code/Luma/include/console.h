@@ -0,0 +1,30 @@
+/**
+ * @file console.h
+ * @author sarvesh
+ * @brief Serial command console
+ * Reads lines from the Serial monitor without blocking the loop and runs the matching command
+ * from a fixed command table - type "help" for the list
+ * @version 1.0
+ * @date 2026-2-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "stdint.h"
+
+#define CONSOLE_LINE_MAX 48     // longest command line, longer input is dropped
+
+typedef void (*ConsoleHandler)(const char *args);  // args -> rest of the line after the command name ("" if none)
+
+struct ConsoleCommand {
+    const char *name;           // first word of the line
+    ConsoleHandler handler;     // runs the command
+    const char *help;           // one line description for "help"
+};
+
+void Console_Poll();    // Consumes pending Serial input, call once per loop
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file coro.h
+ * @author sarvesh
+ * @brief Stackless coroutines for effect choreography
+ * A choreography is written as straight-line code in a step function that returns after every frame, sleep or
+ * wait and continues where it left off on the next call (resume point = the line it suspended on, switch based).
+ * Nothing lives on a stack of its own : values that have to survive a suspension are kept in the effect's context
+ * next to its Coro, so every coroutine frame sits in the EffectContext of its device and nothing is allocated.
+ * A sleeping coroutine costs one compare per frame until its deadline.
+ *
+ *   static bool blinkStep(Blink &blink) {
+ *       CORO_BEGIN(blink.coro);
+ *       for (blink.count = 0; blink.count < 3; blink.count++) {
+ *           Layer_SetPixel(...);
+ *           CORO_SLEEP_MS(blink.coro, 200);    // the loop keeps running, the next step comes 200ms later
+ *           Layer_Clear(...);
+ *           CORO_NEXT_FRAME(blink.coro);
+ *       }
+ *       CORO_END(blink.coro);
+ *   }
+ *
+ * Rules of the step function : locals do not survive a suspension, only one CORO_ macro per line, and no
+ * switch statement of its own around a suspension point
+ * @version 1.0
+ * @date 2026-3-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CORO_H
+#define CORO_H
+
+#include "stdint.h"
+#include "clock.h"
+
+// ==================== Coroutine State ====================
+struct Coro {
+    ClockMs wake;       // suspended until this time of the selected clock, also the base of the next sleep
+    uint16_t line;      // resume point, 0 -> the start of the step function
+    bool running;       // started and not finished or stopped
+};
+
+/**
+ * @brief Makes the next step run the choreography from the start
+ *
+ */
+static inline void Coro_Start(Coro &coro) {
+    coro.wake = Clock_Now();
+    coro.line = 0;
+    coro.running = true;
+}
+
+/**
+ * @brief Ends the choreography wherever it is, the step function returns false from now on
+ *
+ */
+static inline void Coro_Stop(Coro &coro) {
+    coro.running = false;
+}
+
+static inline bool Coro_Running(const Coro &coro) {
+    return coro.running;
+}
+
+/**
+ * @brief Deadline of a sleep that started at the previous deadline - a 30ms sleep on a 20ms frame wakes after 20 or 40ms
+ * and averages 30ms instead of always taking 40. After a long stall (state left, time scale) it starts from now again
+ *
+ */
+static inline ClockMs Coro_Deadline(ClockMs last, uint32_t ms) {
+    ClockMs now = Clock_Now();
+    ClockMs next = last + ms;
+    return next + ms < now ? now + ms : next;
+}
+
+// ==================== Step Function ====================
+// Every macro returns from the step function : true -> still running, false -> finished.
+// A sleep counts from the previous deadline, or from the frame a CORO_NEXT_FRAME / CORO_WAIT_UNTIL resumed on
+#define CORO_BEGIN(coro)                                                        \
+    if (!(coro).running) return false;                                          \
+    if (Clock_Now() < (coro).wake) return true;                                 \
+    switch ((coro).line) { case 0:
+
+#define CORO_NEXT_FRAME(coro)                                                   \
+    do { (coro).line = __LINE__; return true; case __LINE__: (coro).wake = Clock_Now(); } while (0)
+
+#define CORO_SLEEP_MS(coro, ms)                                                 \
+    do {                                                                        \
+        (coro).wake = Coro_Deadline((coro).wake, (ms));                         \
+        (coro).line = __LINE__; return true; case __LINE__:;                    \
+    } while (0)
+
+#define CORO_WAIT_UNTIL(coro, condition)                                        \
+    do {                                                                        \
+        (coro).line = __LINE__; case __LINE__:                                  \
+        if (!(condition)) return true;                                          \
+        (coro).wake = Clock_Now();                                              \
+    } while (0)
+
+#define CORO_END(coro)                                                          \
+    } (coro).running = false; return false
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file easing.h
+ * @author sarvesh
+ * @brief Fixed-point easing curves
+ * Precomputed 8-bit lookup tables shared by the timeline engine and the noise field
+ * @version 1.0
+ * @date 2026-2-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef EASING_H
+#define EASING_H
+
+#include "stdint.h"
+
+// ==================== Easing Curves ====================
+enum Ease {
+    EASE_LINEAR,    // constant speed
+    EASE_IN,        // starts slow, ends fast
+    EASE_OUT,       // starts fast, ends slow
+    EASE_IN_OUT,    // slow - fast - slow (smoothstep)
+    EASE_STEP       // holds the start value and jumps at the end of the segment
+};
+
+extern const uint8_t EASE_LUT[3][256];  // tables for EASE_IN, EASE_OUT and EASE_IN_OUT
+
+/**
+ * @brief Applies an easing curve to a progress value
+ *
+ * @param curve Easing curve
+ * @param t Progress through the segment 0-255
+ * @return uint8_t Eased progress 0-255
+ */
+static inline uint8_t ease8(Ease curve, uint8_t t) {
+    switch (curve) {
+        case EASE_LINEAR: return t;
+        case EASE_STEP:   return t == 255 ? 255 : 0;
+        default:          return EASE_LUT[curve - EASE_IN][t];
+    }
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file flipbook.h
+ * @author sarvesh
+ * @brief Pre-rendered frame sequences played from a flash partition
+ * Sequences (logos, boot animation) are packed by scripts/flipbook.py into the "flipbook" data partition.
+ * The partition is memory mapped once and frames are decoded straight from the mapped flash into the
+ * palette framebuffer, so a sequence never has a copy in RAM
+ * @version 1.0
+ * @date 2026-2-26
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef FLIPBOOK_H
+#define FLIPBOOK_H
+
+#include "stdint.h"
+
+// ==================== Storage ====================
+#define FLIPBOOK_PARTITION  "flipbook"      // label in partitions.csv
+#define FLIPBOOK_SUBTYPE    0x40            // custom data subtype of that partition
+
+// ==================== Image Format ====================
+// Little endian, no alignment - everything is read byte by byte from the mapped window
+//   Directory : 'L' 'F' 'B' '1' | uint32 image length | uint8 count | 3 reserved | count x entry
+//   Entry     : name[8] zero padded | uint32 offset | uint32 length     (offset from the image start)
+//   Sequence  : uint16 frames | uint16 frameMs | uint16 palette size | uint8 width | uint8 height
+//               palette size x RGB (perceptual) | frames...
+//   Frame     : uint8 type | uint8 hold (x 10ms, 0 -> frameMs) | payload
+#define FLIPBOOK_NAME_MAX   8
+#define FLIPBOOK_DIR_SIZE   12
+#define FLIPBOOK_ENTRY_SIZE 16
+#define FLIPBOOK_SEQ_SIZE   8
+#define FLIPBOOK_HOLD_MS    10
+
+enum FlipFrameType {
+    FLIP_KEY,       // NUM_LEDS palette indices
+    FLIP_DELTA,     // uint8 count | count x (pixel, palette index)
+    FLIP_LEVEL      // uint8 palette level -> whole frame fade in one byte
+};
+
+// ==================== Playback ====================
+struct FlipbookPlayer {         // One sequence being played
+    const uint8_t *sequence;    // sequence header inside the mapped window
+    const uint8_t *cursor;      // next frame
+    uint16_t frame;             // frames applied so far
+    uint16_t frameCount;
+    uint16_t frameMs;           // hold time of frames without their own
+    unsigned long nextAt;       // when the next frame is due
+    bool running;
+};
+
+bool Flipbook_Mount();      // Maps the flash partition, call from setup() - false if there is none
+bool Flipbook_Open(FlipbookPlayer &player, const char *name, unsigned long now);   // Validates a sequence and loads its palette
+bool Flipbook_Update(FlipbookPlayer &player, unsigned long now);    // Decodes every due frame into the palette framebuffer, false when done
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file font.h
+ * @author sarvesh
+ * @brief 3x5 bitmap font and scrolling text
+ * Glyphs are stored as column bitmasks, text is drawn one column at a time into a compositor
+ * layer and scrolling only moves a column offset
+ * @version 1.0
+ * @date 2026-2-12
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef FONT_H
+#define FONT_H
+
+#include "stdint.h"
+#include "compositor.h"
+#include "clock.h"
+
+#define FONT_WIDTH   3                  // glyph columns
+#define FONT_HEIGHT  5                  // glyph rows -> bit 0 of a column is the top row
+#define FONT_ADVANCE (FONT_WIDTH + 1)   // glyph + 1 blank spacing column
+
+// ==================== Text ====================
+uint8_t Font_Column(const char *text, uint8_t length, int col);    // Bitmask of one column of a string (0 outside the string)
+void Text_Draw(LayerId layer, const char *text, int scrollCol, int topRow, const Rgb16 &color); // Draws the WIDTH visible columns of a string
+
+// ==================== Scrolling Text ====================
+struct TextScroller {           // One scrolling label
+    const char *text;           // string being scrolled (must stay valid while scrolling)
+    uint8_t length;             // cached strlen
+    int16_t offset;             // string column shown in the left most matrix column
+    uint16_t stepMs;            // time per column
+    ClockMs lastStep;           // when the offset last moved
+    bool active;                // false once the string has left the matrix
+};
+
+void Scroller_Start(TextScroller &scroller, const char *text, uint16_t stepMs);    // Text enters from the right edge
+bool Scroller_Update(TextScroller &scroller);       // Advances the offset when a step is due, returns true if the visible columns moved
+void Scroller_Draw(const TextScroller &scroller, LayerId layer, int topRow, const Rgb16 &color); // Draws the visible columns
+
+#endif
@@ -13,38 +13,67 @@
 #define FSM_H
 
 #include <Arduino.h>
+#include "gesture.h"
+#include "profiles.h"
+#include "clock.h"
+#include "animations.h"
+#include "timeline.h"
+#include "font.h"
+#include "flipbook.h"
 
 // ==================== Luma State Definition ====================
+// IDs stay the same in every profile, a state that is not compiled in is simply never entered
 enum LumaState {               // States of Luma : Every Page/Screens
     STATE_DEVICE_ON,           // [Device] Power-on animation (1.5 sec)
     STATE_DEVICE_SCREENSAVER,  // [Device] Idle breathing hourglass (infinite)
     STATE_DEVICE_MENU,         // [Device] Choose TIMER or THEMES (infinite)
     STATE_COLOR_FLOOD,         // Color flood interaction
     STATE_FALLING_PIXEL,       // Falling Pixel interaction
+    STATE_AURORA,              // Aurora ambient mode (noise field)
+    STATE_SCRIPT,              // Bytecode program uploaded over serial
     STATE_ERROR                // Error state (optional)
 };
 
 // ==================== Luma Menu Option ====================
-enum MenuOption {           // Sub States of FSM - Menu Option
+enum MenuOption {           // Sub States of FSM - Menu Option (only the interactions of the build profile)
+#if LUMA_FEATURE_COLOR_FLOOD
     MENU_COLOR_FLOOD,       // Corresponds to STATE_COLOR_FLOOD
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
     MENU_FALLING_PIXELS,    // Corresponds to STATE_FALLING_PIXEL
+#endif
+#if LUMA_FEATURE_AURORA
+    MENU_AURORA,            // Corresponds to STATE_AURORA
+#endif
+#if LUMA_FEATURE_SCRIPT
+    MENU_SCRIPT,            // Corresponds to STATE_SCRIPT
+#endif
     MENU_COUNT              // This is used to wrap around and bound checking
 };
 extern const char* menuNames[MENU_COUNT];   // Global read only array of menu names
 
+struct RenderTarget;    // offscreen frame from compositor.h
+
 
 // ==================== FSM Class ====================
 class LumaFSM {
     public:
         LumaFSM();                              // Constructors sets defaults - intial settings
+        ~LumaFSM();                             // Releases the crossfade frames
+        LumaFSM(const LumaFSM &) = delete;      // owns render targets
+        LumaFSM &operator=(const LumaFSM &) = delete;
         void update();                          // main loop handles current state (calls every 20ms)
-        void onButtonAPressed(bool longPress);  // Button A logic
-        void onButtonBPressed(bool longPress);  // Button B logic
+        void onButtonAPressed(bool longPress, uint16_t eventId = 0);    // Button A logic, eventId from Latency_Input()
+        void onButtonBPressed(bool longPress, uint16_t eventId = 0);    // Button B logic, eventId from Latency_Input()
+        void onGesture(Gesture gesture, uint16_t eventId = 0);          // Every recognized gesture, taps & holds go to the button handlers
+        uint16_t getStateGestures() const;                              // Optional gestures the current state consumes (GESTURE_BIT mask)
         
         // Read current values
         LumaState getCurrentState() const { return currentState; }              // Gets the current FSM State  
         MenuOption getCurrentMenuOption() const { return selectedMenuOption; }  // Gets the current FSM Sub State
 
+        void restoreSnapshot();                 // Restores the last stored snapshot, call from setup() - skips the boot with fast boot on
+
     private:
         // States Tracking
         LumaState currentState;             // active state 
@@ -54,20 +83,69 @@ class LumaFSM {
         MenuOption selectedMenuOption;      // Menu option selected by user
 
         // State Timing
-        unsigned long stateStartTime;       // When current state began
+        ClockMs stateStartTime;             // When current state began (on the state's clock)
         unsigned long timerStartTime;       // When RUNNING state timer started
         unsigned long totalTimerDuration;   // Total ms for countdown
 
+        // Effects - every bit of animation state of this device lives here, nothing in file statics
+        EffectContext effects;
+
+        // Boot animation
+        TimelinePlayer bootPlayer;          // plays BOOT_TIMELINE
+        FlipbookPlayer bootFlip;            // plays the "boot" flipbook sequence instead, if the partition has one
+        uint8_t offCount;                   // leds already switched off by the collapse
+
+        // Screensaver (The state handler and Button Handler both need this) - the orb itself is effects.orb
+        SaverPhase phase;
+
+        // Menu
+        TextScroller menuLabel;             // scrolls once over the preview whenever the menu is entered or cycled
+        uint8_t backgroundPreview;          // preview that gets the background step this tick
+        void drawMenuPreview(MenuOption option);
+
+        // First entry flags of the interactions
+        bool colorFloodInit;
+        bool fallingPixelInit;
+        bool auroraInit;
+        bool scriptInit;
+
         // State Handlers for each State of FSM - Each handlers has its own logic and update function
         void handleState_DeviceOn();
         void handleState_DeviceScreensaver();
         void handleState_DeviceMenu();
+#if LUMA_FEATURE_COLOR_FLOOD
         void handleState_ColorFlood();
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
         void handleState_FallingPixel();
+#endif
+#if LUMA_FEATURE_AURORA
+        void handleState_Aurora();
+#endif
+#if LUMA_FEATURE_SCRIPT
+        void handleState_Script();
+#endif
 
         // State Transitions 
         void transitionTo(LumaState newState);
 
+        // Snapshots
+        void offerSnapshot();               // hands the current state to the snapshot writer
+
+        // Rendering
+        uint16_t getStateLayers() const;    // compositor layers shown by the current state
+        uint16_t getInputLayers() const;    // state layers that show the result of a button action
+
+        // State Crossfade - outgoing frame is frozen in fadeFrom, incoming state renders into fadeTo
+        RenderTarget* fadeFrom;             // last frame of the previous state
+        RenderTarget* fadeTo;               // current frame of the new state
+        uint8_t fadeFrame;                  // frames of the crossfade already shown
+        void startCrossfade(uint16_t outgoingLayers);
+        void presentFrame();                // composite (or crossfade) the current frame to the matrix
+
+        // Latency Tracing
+        uint16_t inputEvent;                // latest handled input event that is not on the LEDs yet (0 -> none)
+
         // Utilities (for Serial Debugging)
         unsigned long getStateElapsedTime() const;
         void logStateTransition(LumaState from, LumaState to);
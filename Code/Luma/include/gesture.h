@@ -0,0 +1,58 @@
+/**
+ * @file gesture.h
+ * @author sarvesh
+ * @brief Gesture recognizer for the two buttons
+ * Turns the raw button levels into taps, holds, double / triple taps, hold-to-repeat and A+B chords.
+ * Runs on timestamps with a fixed amount of state per button, and only waits for a follow up tap
+ * when the current state actually consumes a multi tap gesture - otherwise a tap is reported on release
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include "stdint.h"
+
+// ==================== Timing ====================
+#define GESTURE_DEBOUNCE_MS     20      // presses shorter than this are noise
+#define GESTURE_LONG_MS         1000    // press longer than this is a hold
+#define GESTURE_TAP_GAP_MS      250     // max release -> press gap inside a double / triple tap
+#define GESTURE_REPEAT_DELAY_MS 400     // hold time before the first repeat
+#define GESTURE_REPEAT_START_MS 250     // first repeat interval
+#define GESTURE_REPEAT_MIN_MS   60      // repeat interval stops accelerating here
+#define GESTURE_QUEUE           4       // recognized gestures waiting for dispatch
+
+// ==================== Gestures ====================
+// Both buttons have the same 5 gestures in the same order, so a button gesture is GESTURE_A_x + button * GESTURE_PER_BUTTON
+enum Gesture {
+    GESTURE_A_TAP,          // short press A
+    GESTURE_A_HOLD,         // long press A (reported on release)
+    GESTURE_A_DOUBLE,       // two quick taps on A
+    GESTURE_A_TRIPLE,       // three quick taps on A
+    GESTURE_A_REPEAT,       // A held down, repeats at an accelerating rate
+    GESTURE_B_TAP,
+    GESTURE_B_HOLD,
+    GESTURE_B_DOUBLE,
+    GESTURE_B_TRIPLE,
+    GESTURE_B_REPEAT,
+    GESTURE_CHORD,          // A and B pressed together, reported when both are released
+    GESTURE_CHORD_HOLD,     // same but held longer than GESTURE_LONG_MS
+    GESTURE_COUNT
+};
+
+#define GESTURE_PER_BUTTON 5
+#define GESTURE_BIT(g) ((uint16_t)1 << (g))     // gesture masks -> what a state consumes
+
+// Taps and holds are always reported, these only when the current state declares them
+#define GESTURE_OPTIONAL (GESTURE_BIT(GESTURE_A_DOUBLE) | GESTURE_BIT(GESTURE_A_TRIPLE) | GESTURE_BIT(GESTURE_A_REPEAT) | \
+                          GESTURE_BIT(GESTURE_B_DOUBLE) | GESTURE_BIT(GESTURE_B_TRIPLE) | GESTURE_BIT(GESTURE_B_REPEAT) | \
+                          GESTURE_BIT(GESTURE_CHORD) | GESTURE_BIT(GESTURE_CHORD_HOLD))
+
+void Gesture_Update(bool aDown, bool bDown, uint16_t consumed, unsigned long now);   // Feeds the button levels, call every poll
+bool Gesture_Next(Gesture &gesture);    // Pops the next recognized gesture, false when there is none
+void Gesture_Reset();                   // Forgets presses in progress and queued gestures (buttons up)
+
+#endif
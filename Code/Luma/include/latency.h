@@ -0,0 +1,39 @@
+/**
+ * @file latency.h
+ * @author sarvesh
+ * @brief Input to photon latency tracing and loop watchdog
+ * Every button action gets an event id stamped with the time of its GPIO edge (hold repeats: when recognized). The id travels through the
+ * FSM button handlers to the first shown frame that redrew the layers of the action (during a crossfade the first
+ * frame far enough into the blend), and the edge -> show() time goes into a histogram of the state the input was
+ * handled in. Loop iterations that run longer than LOOP_WARN_MS are flagged
+ * @version 1.0
+ * @date 2026-2-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "stdint.h"
+#include "fsm.h"
+
+#define LAT_STATES      (STATE_ERROR + 1)   // one histogram per LumaState
+#define LAT_BUCKETS     8                   // <4, <8, <16 ... <256, >=256 ms
+#define LAT_PENDING     4                   // input events waiting for their frame
+#define LAT_TIMEOUT_MS  1000                // event without a shown frame after this is counted as lost
+#define LOOP_WARN_MS    100                 // loop watchdog threshold -> a few frames of 20ms
+
+// BOTH -> whichever edge came last (chords), NONE -> no edge, measured from the call (hold repeats fire with the button down)
+enum LatencyButton { LAT_BUTTON_A, LAT_BUTTON_B, LAT_BUTTON_BOTH, LAT_BUTTON_NONE };
+
+void Latency_Init(int pinA, int pinB);                                  // Timestamps the GPIO edges of both buttons
+uint16_t Latency_Input(LatencyButton button, LumaState state);          // New input event, returns its id (never 0)
+void Latency_Photon(uint16_t eventId);                                  // A frame was shown with every event up to eventId handled
+
+void Latency_LoopBegin();                   // Call at the top of loop()
+void Latency_LoopEnd(LumaState state);      // Call before the frame delay, flags slow iterations
+
+void Latency_Print(const char *args);       // Prints the histograms (console command "lat", "lat reset" clears them)
+
+#endif
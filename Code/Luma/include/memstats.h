@@ -0,0 +1,57 @@
+/**
+ * @file memstats.h
+ * @author sarvesh
+ * @brief Memory budgets and runtime memory statistics
+ * Every subsystem keeps its state in fixed size file-scope statics, so its RAM cost is known at build
+ * time and is checked against the budgets below with a static_assert next to the statics.
+ * At runtime the loop task stack high-water mark and the heap minimum are tracked and printed with
+ * the "mem" console command
+ * @version 1.0
+ * @date 2026-2-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include "stdint.h"
+
+// ==================== Static Budgets ====================
+// Bytes of file-scope statics per subsystem - raise a budget on purpose, never just to make the build pass
+#define MEM_BUDGET_COMPOSITOR   5120    // 16-bit linear layers + render target pool + output frame
+#define MEM_BUDGET_PALETTE      1664    // indexed frame + 16-bit linear palette
+#define MEM_BUDGET_ANIMATIONS   768     // one EffectContext : flood pool, settled grid, falling pool, orb hit, previews
+#define MEM_BUDGET_FSM          256     // LumaFSM without its EffectContext : boot player, menu label, screensaver orb
+#define MEM_BUDGET_MATRIX       256     // NeoPixel pixel buffer (allocated by the library before setup)
+#define MEM_BUDGET_CONSOLE      64      // serial command line buffer
+#define MEM_BUDGET_LATENCY      256     // latency histograms + pending input events
+#define MEM_BUDGET_GESTURE      128     // button trackers + gesture queue
+#define MEM_BUDGET_OUTPUT       1792    // brightness / white balance / LED curve tables + dither error
+#define MEM_BUDGET_VM           768     // bytecode program, operand stack and registers
+#define MEM_BUDGET_FLIPBOOK     16      // mapped window only - sequences are never copied to RAM
+#define MEM_BUDGET_SNAPSHOT     128     // last written snapshot blob + write policy state
+#define MEM_BUDGET_CLOCK        192     // per state clocks + 64-bit uptime
+#define MEM_BUDGET_TUNE         64      // tunable values - the registry table is in flash
+#define MEM_BUDGET_CANVAS       2304    // 64x64 world of 4-bit cells + tile counts + cell colors
+#ifdef LUMA_TRACE
+#define MEM_BUDGET_TRACE        3136    // span ring, 256 spans of 12 bytes - [env:trace] only
+#else
+#define MEM_BUDGET_TRACE        0
+#endif
+#ifdef LUMA_STRESS
+#define MEM_BUDGET_STRESS       1792    // simulated LumaFSM + sequence & shrink candidate + worst frame per state - [env:stress] only
+#else
+#define MEM_BUDGET_STRESS       0
+#endif
+#define MEM_BUDGET_TOTAL        (13952 + MEM_BUDGET_TRACE + MEM_BUDGET_STRESS)  // everything above must fit in this
+
+// ==================== Runtime Thresholds ====================
+#define MEM_SAMPLE_MS       1000    // how often the high-water marks are sampled
+#define MEM_STACK_WARN      1024    // warn when the loop task has less free stack than this (bytes)
+
+void MemStats_SealHeap();   // Call at the end of setup() - from here on the loop must not allocate
+void MemStats_Update();     // Samples the high-water marks, call once per loop
+void MemStats_Print(const char *args);  // Prints the memory report (console command "mem")
+
+#endif
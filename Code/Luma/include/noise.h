@@ -0,0 +1,27 @@
+/**
+ * @file noise.h
+ * @author sarvesh
+ * @brief Fixed-point 3D gradient noise
+ * Integer only Perlin style noise built on a permutation table and a gradient lookup,
+ * used by the ambient modes to get smooth organic motion (time is the third axis)
+ * @version 1.0
+ * @date 2026-2-2
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef NOISE_H
+#define NOISE_H
+
+#include "stdint.h"
+
+// Noise coordinates are 8.8 fixed point -> upper byte is the lattice cell, lower byte is the position inside the cell
+#define NOISE_CELL 256      // one lattice cell in noise coordinates
+
+uint8_t noise3D(uint16_t x, uint16_t y, uint16_t z);   // Samples the noise field, returns 0-255 (128 is the mid level)
+
+#ifdef LUMA_BENCH
+void Noise_Benchmark();     // Prints noise samples per second over Serial
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file output.h
+ * @author sarvesh
+ * @brief Output stage - the only place linear light becomes LED drive values
+ * One lookup table per channel combines global brightness, white balance and the LED response curve,
+ * it is rebuilt only when a setting changes and costs one interpolated table read per channel per pixel.
+ * The table output has 8 fractional bits, temporal dithering spreads them across frames so dim levels
+ * and fade tails keep their in-between steps instead of snapping to the nearest 8-bit level.
+ * A power limiter estimates the LED current of every frame and scales the drive down from the next frame
+ * on when it goes over the supply budget, so effects can use full brightness on a USB port
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "stdint.h"
+#include "color.h"
+
+// ==================== Output Configuration ====================
+#ifndef OUTPUT_BRIGHTNESS
+#define OUTPUT_BRIGHTNESS 255   // boot brightness 0-255, perceptual -> 128 looks half as bright
+#endif
+#ifndef OUTPUT_GAMMA
+#define OUTPUT_GAMMA 1.0f       // LED response correction applied to linear light | 1.0 -> WS2812B PWM is linear
+#endif
+
+#ifndef OUTPUT_DITHER
+#define OUTPUT_DITHER 1         // temporal dithering at boot | 0 -> plain rounding
+#endif
+
+#ifndef OUTPUT_POWER_MA
+#define OUTPUT_POWER_MA 450     // LED current budget at boot in mA, the share of a 500 mA USB port left for the panel | 0 -> no limit
+#endif
+#ifndef OUTPUT_MA_PER_CHANNEL
+#define OUTPUT_MA_PER_CHANNEL 20    // WS2812B current of one channel at level 255
+#endif
+#ifndef OUTPUT_MA_IDLE
+#define OUTPUT_MA_IDLE 1        // WS2812B current of a dark pixel
+#endif
+
+#define OUTPUT_LUT_SIZE 257     // lut[k] = drive at linear k * 256, the extra entry is the top of the last span
+
+// ==================== Output Stage ====================
+void Output_SetBrightness(uint8_t level);                   // Global brightness, applied in the LUT
+void Output_SetWhiteBalance(uint8_t r, uint8_t g, uint8_t b);   // Per channel gain 0-255 (255 -> unchanged)
+void Output_SetDither(bool enabled);        // Temporal dithering on / off
+void Output_SetPowerBudget(uint16_t milliamps); // LED current budget, 0 -> no limit
+
+void Output_Show(const Rgb16 *frame);       // Encodes a full frame (NUM_LEDS pixels) into the matrix and shows it
+bool Output_Refresh();                      // Re-shows the last frame while dithering or the limiter release still change it
+void Output_Reset();                        // Limiter and dither as after power on, settings kept (stress runs)
+void Output_PowerCommand(const char *args); // Console command "power" - limiter status | reset
+
+#ifdef LUMA_BENCH
+void Output_Benchmark();    // Prints the per frame cost of the output stage over Serial
+#endif
+
+#ifdef LUMA_STRESS
+void Output_SetMuted(bool mute);    // Frames are still encoded but not sent to the LEDs (stress campaign)
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file palette.h
+ * @author sarvesh
+ * @brief Palette indexed framebuffer
+ * Optional 8-bit framebuffer where every pixel stores a palette index instead of a color.
+ * Colors are expanded to linear light only when the compositor presents LAYER_PALETTE, so palette rotation and
+ * palette-wide fades are one value each instead of touching every pixel
+ * @version 1.0
+ * @date 2026-2-4
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include "stdint.h"
+#include "color.h"
+
+#define PALETTE_SIZE 256    // one entry per possible index byte
+
+// ==================== Palette Owners ====================
+// Effects sharing the palette rebuild it when they take it over from another effect
+enum PaletteOwner {
+    PALETTE_OWNER_NONE,
+    PALETTE_OWNER_BOOT,     // boot TV bars
+    PALETTE_OWNER_AURORA,   // aurora mode & its menu preview
+    PALETTE_OWNER_FLIPBOOK  // flipbook sequences bring their own palette
+};
+
+bool Palette_Acquire(PaletteOwner owner);           // Takes over the palette, returns true if the caller has to (re)build its entries
+
+// ==================== Palette ====================
+void Palette_Set(uint8_t index, const Rgb16 &color);   // Sets one palette entry (linear light)
+void Palette_SetRotation(uint8_t offset);          // Palette cycling - pixel index i shows entry (i + offset)
+void Palette_SetLevel(uint8_t level);              // Palette-wide brightness 0-255 -> fades the whole frame, applied on expansion
+
+// ==================== Indexed Framebuffer ====================
+void Palette_Clear();                               // Sets every pixel to index 0
+void Palette_SetPixel(int idx, uint8_t index);      // Writes a palette index into the framebuffer
+uint8_t Palette_GetPixel(int idx);                  // Reads a palette index back from the framebuffer
+void Palette_Reset();                               // Back to the power on state, no owner (stress runs)
+
+// ==================== Compositor Hooks ====================
+Rgb16 Palette_GetColor(int idx);                    // Expanded color of one pixel (index -> rotation -> palette -> level)
+Rgb16 Palette_Lookup(uint8_t index);                // Expanded color of a palette index
+
+#endif
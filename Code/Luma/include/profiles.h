@@ -0,0 +1,98 @@
+/**
+ * @file profiles.h
+ * @author sarvesh
+ * @brief Build-time feature profiles
+ * A platformio.ini environment picks a profile with -D LUMA_PROFILE_x, the profile decides which
+ * interactions and diagnostics are compiled in. Disabled interactions lose their state handlers, menu entry,
+ * menu name and compositor layers; disabled logging drops the log strings from flash
+ * @version 1.0
+ * @date 2026-2-22
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef PROFILES_H
+#define PROFILES_H
+
+// ==================== Profiles ====================
+// Single features can still be overridden with their own -D LUMA_FEATURE_x=0/1
+#if defined(LUMA_PROFILE_MINIMAL)           // one interaction, no serial output at all
+#define LUMA_PROFILE "minimal"
+#ifndef LUMA_FEATURE_COLOR_FLOOD
+#define LUMA_FEATURE_COLOR_FLOOD   1
+#endif
+#ifndef LUMA_FEATURE_FALLING_PIXEL
+#define LUMA_FEATURE_FALLING_PIXEL 0
+#endif
+#ifndef LUMA_FEATURE_AURORA
+#define LUMA_FEATURE_AURORA        0
+#endif
+#ifndef LUMA_FEATURE_SCRIPT
+#define LUMA_FEATURE_SCRIPT        0
+#endif
+#ifndef LUMA_FEATURE_CONSOLE
+#define LUMA_FEATURE_CONSOLE       0
+#endif
+#ifndef LUMA_FEATURE_LOG
+#define LUMA_FEATURE_LOG           0
+#endif
+
+#elif defined(LUMA_PROFILE_KIOSK_STREAM)    // unattended ambient display, console kept for remote stats
+#define LUMA_PROFILE "kiosk-stream"
+#ifndef LUMA_FEATURE_COLOR_FLOOD
+#define LUMA_FEATURE_COLOR_FLOOD   0
+#endif
+#ifndef LUMA_FEATURE_FALLING_PIXEL
+#define LUMA_FEATURE_FALLING_PIXEL 0
+#endif
+#ifndef LUMA_FEATURE_AURORA
+#define LUMA_FEATURE_AURORA        1
+#endif
+#ifndef LUMA_FEATURE_SCRIPT
+#define LUMA_FEATURE_SCRIPT        0
+#endif
+#ifndef LUMA_FEATURE_CONSOLE
+#define LUMA_FEATURE_CONSOLE       1
+#endif
+#ifndef LUMA_FEATURE_LOG
+#define LUMA_FEATURE_LOG           0
+#endif
+
+#else                                       // full - everything (default)
+#define LUMA_PROFILE "full"
+#ifndef LUMA_FEATURE_COLOR_FLOOD
+#define LUMA_FEATURE_COLOR_FLOOD   1
+#endif
+#ifndef LUMA_FEATURE_FALLING_PIXEL
+#define LUMA_FEATURE_FALLING_PIXEL 1
+#endif
+#ifndef LUMA_FEATURE_AURORA
+#define LUMA_FEATURE_AURORA        1
+#endif
+#ifndef LUMA_FEATURE_SCRIPT
+#define LUMA_FEATURE_SCRIPT        1
+#endif
+#ifndef LUMA_FEATURE_CONSOLE
+#define LUMA_FEATURE_CONSOLE       1
+#endif
+#ifndef LUMA_FEATURE_LOG
+#define LUMA_FEATURE_LOG           1
+#endif
+#endif
+
+#if !(LUMA_FEATURE_COLOR_FLOOD || LUMA_FEATURE_FALLING_PIXEL || LUMA_FEATURE_AURORA || LUMA_FEATURE_SCRIPT)
+#error "Luma needs at least one interaction for the menu"
+#endif
+
+// ==================== Feature Flags ====================
+// Code that only calls into a feature tests these instead of #if - the branch folds away at compile time
+// and the linker drops everything the remaining code no longer references
+constexpr bool FEATURE_CONSOLE = LUMA_FEATURE_CONSOLE;
+constexpr bool FEATURE_LOG     = LUMA_FEATURE_LOG;
+
+// ==================== Logging ====================
+// Log strings only reach the image when FEATURE_LOG is set
+#define LOG(msg)      do { if (FEATURE_LOG) Serial.println(msg); } while (0)    // one full log line
+#define LOG_PART(msg) do { if (FEATURE_LOG) Serial.print(msg); } while (0)      // part of a log line
+
+#endif
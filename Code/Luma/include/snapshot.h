@@ -0,0 +1,52 @@
+/**
+ * @file snapshot.h
+ * @author sarvesh
+ * @brief Persisted state snapshots and fast boot
+ * The FSM offers a compact snapshot of itself (state, menu option, packed Falling Pixel board) once per second.
+ * A change is only written to NVS after it has settled and never more often than SNAPSHOT_GAP_MS, and an
+ * unchanged snapshot is never written again - so bursts of activity cost one flash write, idle costs none.
+ * setup() restores the last snapshot; with fast boot on the boot animation is skipped as well
+ * @version 1.0
+ * @date 2026-2-28
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "stdint.h"
+#include "animations.h"
+
+// ==================== Write Policy ====================
+#define SNAPSHOT_CHECK_MS   1000    // how often the FSM offers a snapshot
+#define SNAPSHOT_SETTLE_MS  5000    // a change is written once nothing changed for this long -> bursts coalesce
+#define SNAPSHOT_GAP_MS     60000   // minimum time between two writes, whatever happens (flash wear)
+
+#ifndef LUMA_FAST_BOOT
+#define LUMA_FAST_BOOT 0            // 1 -> power on goes straight back to the last state (also "snap fast on")
+#endif
+
+// ==================== Storage ====================
+// Blob (little endian) : version | writes u32 | flags | state | menu option | packed board
+#define SNAPSHOT_VERSION    2
+#define SNAPSHOT_NAMESPACE  "luma-snap"
+#define SNAPSHOT_KEY        "state"
+#define SNAPSHOT_HEADER     5               // version + write counter, not part of the comparison
+#define SNAPSHOT_MAX        (SNAPSHOT_HEADER + 3 + FALL_PACK_MAX)
+
+struct Snapshot {       // What the FSM restores
+    uint8_t state;      // LumaState
+    uint8_t menuOption; // MenuOption
+    uint8_t boardLength;            // 0 -> no Falling Pixel board
+    uint8_t board[FALL_PACK_MAX];   // FallingPixel_Pack()
+};
+
+bool Snapshot_Load(Snapshot &snapshot);     // Reads the last snapshot, call from setup() - false if there is none
+bool Snapshot_FastBoot();                   // true if power on should skip the boot animation
+bool Snapshot_Due(unsigned long now);       // true once per SNAPSHOT_CHECK_MS
+void Snapshot_Offer(const Snapshot &snapshot, unsigned long now);  // Writes the snapshot when the policy above allows it
+
+void Snapshot_Command(const char *args);    // Console command "snap" - status | fast on/off | clear
+
+#endif
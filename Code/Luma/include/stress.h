@@ -0,0 +1,53 @@
+/**
+ * @file stress.h
+ * @author sarvesh
+ * @brief Randomized input stress runner
+ * Drives a simulated device (its own LumaFSM, the real gesture recognizer and compositor) with random and
+ * adversarial button sequences - tap storms that fill every flood slot, long-press spam that fills the
+ * Falling Pixel board and triggers its finale, menu cycling storms, chords - and times update + present of
+ * every frame. The worst frame of every state is kept together with the sequence that led to it, which is
+ * then shrunk to a minimal reproducer (Serial, e.g. "B60 _2 B60 _2 B60" -> hold B 60 frames, release 2 frames ...).
+ * Frames run back to back with the frame delay skipped and the LEDs are not updated, so a replay costs only the
+ * frame work - the whole campaign is bounded by STRESS_REPLAY_MAX replays and still takes minutes.
+ * Only [env:stress] (-D LUMA_STRESS) has it, the campaign runs once at boot before the device starts
+ * @version 1.0
+ * @date 2026-3-13
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef STRESS_H
+#define STRESS_H
+
+#include "stdint.h"
+
+#ifdef LUMA_STRESS
+
+// ==================== Configuration ====================
+#ifndef STRESS_RUNS
+#define STRESS_RUNS         16      // random sequences per campaign
+#endif
+#ifndef STRESS_SEED
+#define STRESS_SEED         1       // seed of the first run, run i uses STRESS_SEED + i -> a campaign always replays the same
+#endif
+#define STRESS_MAX_STEPS    128     // button level changes per sequence
+#define STRESS_BOOT_TICKS   300     // idle frames before the sequence - the boot animation is 5.5s
+#define STRESS_TAIL_TICKS   150     // idle frames after it, so effects started by the last input play out
+#define STRESS_FRAME_MS     20      // virtual frame delay, same as loop()
+#define STRESS_REPRO_PCT    75      // a shrunk sequence still reproduces if its worst frame reaches this share of the original
+#define STRESS_REPLAY_MAX   160     // replays of the whole campaign, runs included - the shrinks share what the runs leave
+
+// ==================== Sequences ====================
+#define STRESS_A 0x01               // StressStep::buttons bits
+#define STRESS_B 0x02
+
+struct StressStep {     // Buttons held at one level for a while
+    uint8_t buttons;    // STRESS_A | STRESS_B, 0 -> both released
+    uint8_t ticks;      // frames the level is held, 1 - 255
+};
+
+void Stress_Run();      // Runs the campaign and prints the worst frame per state with its shrunk reproducer
+
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file timeline.h
+ * @author sarvesh
+ * @brief Keyframe / tween timeline engine
+ * Choreography is described as data - tracks of keyframes with easing curves - and a player
+ * walks the tables incrementally every tick using fixed point math only
+ * @version 1.0
+ * @date 2026-2-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "stdint.h"
+#include "easing.h"
+
+#define TIMELINE_MAX_TRACKS 4   // tracks per timeline -> fixed size player, no dynamic allocation
+
+// ==================== Timeline Data ====================
+struct Keyframe {       // One point of a track
+    uint16_t timeMs;    // time from the start of the timeline
+    int16_t value;      // value reached at timeMs (position, hue, brightness ...)
+    Ease ease;          // curve of the segment that ends at this keyframe
+};
+
+struct Track {              // One animated value
+    const Keyframe *keys;   // keyframes sorted by time, first one should be at 0ms
+    uint8_t count;          // number of keyframes
+};
+
+struct Timeline {           // A whole choreography
+    const Track *tracks;    // one entry per animated value
+    uint8_t trackCount;     // up to TIMELINE_MAX_TRACKS
+};
+
+#define TRACK(keys) { keys, sizeof(keys) / sizeof(keys[0]) }         // builds a Track from a Keyframe array
+#define TIMELINE(tracks) { tracks, sizeof(tracks) / sizeof(tracks[0]) }  // builds a Timeline from a Track array
+
+// ==================== Timeline Player ====================
+struct TrackCursor {        // Incremental evaluation state of one track
+    uint8_t segment;        // keyframe the current segment ends at
+    uint32_t rate;          // 16.16 progress per ms of the current segment -> one divide per segment, not per frame
+};
+
+// Progress runs 0-255 over a segment, rate = TIMELINE_RATE_END / span. Keyframe times are 16 bits, so the longest
+// span is 65535ms and its rate is still 255 -> progress is never more than 1 below time * 255 / span for any span,
+// and time into the segment * rate stays below TIMELINE_RATE_END (no 32-bit overflow)
+#define TIMELINE_RATE_END (255UL << 16)
+static_assert(sizeof(((Keyframe *)0)->timeMs) == 2, "segment spans above 65535ms lose rate precision");
+
+struct TimelinePlayer {
+    const Timeline *timeline;                   // what is being played
+    TrackCursor cursors[TIMELINE_MAX_TRACKS];   // where each track is
+    int16_t values[TIMELINE_MAX_TRACKS];        // values of the last tick
+    uint16_t duration;                          // time of the last keyframe of all tracks
+    bool running;                               // false once the last keyframe was reached
+};
+
+void Timeline_Start(TimelinePlayer &player, const Timeline &timeline);     // Resets the player to the start of a timeline
+bool Timeline_Tick(TimelinePlayer &player, unsigned long elapsedMs);       // Evaluates all tracks at elapsedMs, returns false when finished
+
+/**
+ * @brief Value of one track as of the last tick
+ *
+ */
+static inline int16_t Timeline_Value(const TimelinePlayer &player, uint8_t track) {
+    return player.values[track];
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file trace.h
+ * @author sarvesh
+ * @brief Scoped trace spans
+ * TRACE_SPAN("name") at the top of a scope records when the scope started and how long it ran into a ring buffer
+ * of the last TRACE_CAPACITY spans, timed with the CPU cycle counter. The "trace" console command dumps the ring
+ * as Chrome trace-event JSON - open it in Perfetto (ui.perfetto.dev) or chrome://tracing to see every frame on a
+ * timeline. Only [env:trace] (-D LUMA_TRACE) records anything, every other build compiles the spans to nothing
+ * @version 1.0
+ * @date 2026-3-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "stdint.h"
+
+#ifdef LUMA_TRACE
+
+// ==================== Configuration ====================
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 256          // spans kept, oldest are overwritten -> ~30 frames of the full profile
+#endif
+
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0, "TRACE_CAPACITY must be a power of two");
+
+uint32_t Trace_Now();                                           // CPU cycle counter
+void Trace_Record(const char *name, uint32_t start, uint32_t end);  // Adds a finished span to the ring
+
+// ==================== Spans ====================
+class TraceSpan {   // Records its scope when it goes out of scope
+    public:
+        explicit TraceSpan(const char *name) : name(name), start(Trace_Now()) {}
+        ~TraceSpan() { Trace_Record(name, start, Trace_Now()); }
+
+    private:
+        const char *name;   // string literal, only the pointer is stored
+        uint32_t start;
+};
+
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b)  TRACE_JOIN2(a, b)
+#define TRACE_SPAN(name)  TraceSpan TRACE_JOIN(traceSpan, __LINE__)(name)
+
+void Trace_Init();                      // Reads the cycle counter rate
+void Trace_Command(const char *args);   // Console command "trace" - dump | clear
+
+#else
+
+#define TRACE_SPAN(name)  do {} while (0)
+static inline void Trace_Init() {}
+
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file tune.h
+ * @author sarvesh
+ * @brief Runtime tunables
+ * Effect timings, fades, speeds and the output settings are named variables with a range, listed once in
+ * TUNABLES below. Code reads them with TUNE(name), which is a plain global - no lookup on the hot path.
+ * The console command "set" lists them and changes them while the device runs, "set save" keeps the
+ * current values in NVS so an installation is tuned without reflashing
+ * @version 1.0
+ * @date 2026-3-6
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "stdint.h"
+#include "output.h"
+
+// ==================== Tunables ====================
+// X(name, type, default, min, max, apply, help) - name is also the NVS key (max 15 characters), type uint8_t or uint16_t,
+// apply runs after the value changed (nullptr -> the value is only read where it is used)
+#define TUNABLES(X) \
+    X(brightness,     uint8_t,  OUTPUT_BRIGHTNESS, 0, 255,  Tune_ApplyOutput, "global brightness (perceptual)")          \
+    X(wb_red,         uint8_t,  255,               0, 255,  Tune_ApplyOutput, "white balance red gain")                  \
+    X(wb_green,       uint8_t,  255,               0, 255,  Tune_ApplyOutput, "white balance green gain")                \
+    X(wb_blue,        uint8_t,  255,               0, 255,  Tune_ApplyOutput, "white balance blue gain")                 \
+    X(dither,         uint8_t,  OUTPUT_DITHER,     0, 1,    Tune_ApplyOutput, "temporal dithering on / off")             \
+    X(power_ma,       uint16_t, OUTPUT_POWER_MA,   0, 4000, Tune_ApplyOutput, "LED current budget (mA, 0 -> no limit)")  \
+    X(label_ms,       uint16_t, 70,                10, 1000, nullptr,         "menu label time per column (ms)")         \
+    X(orb_speed,      uint8_t,  12,                2, 60,   nullptr,         "fastest respawned orb (pixels per second)") \
+    X(menu_flood_ms,  uint16_t, 55,                10, 1000, nullptr,         "Color Flood preview step time (ms)")      \
+    X(menu_fall_ms,   uint16_t, 90,                10, 1000, nullptr,         "Falling Pixel preview step time (ms)")    \
+    X(menu_aurora_ms, uint16_t, 40,                10, 1000, nullptr,         "Aurora preview frame time (ms)")          \
+    X(flood_ms,       uint16_t, 55,                10, 1000, nullptr,         "Color Flood step time (ms)")              \
+    X(flood_hue,      uint16_t, 200,               0, 8000, nullptr,         "Color Flood hue change per ring")         \
+    X(flood_fade,     uint8_t,  230,               0, 255,  Tune_ApplyLayers, "Color Flood brightness kept per step /256") \
+    X(fall_ms,        uint16_t, 25,                5, 1000, nullptr,         "Falling Pixel step time (ms)")            \
+    X(trail_fade,     uint8_t,  150,               0, 255,  Tune_ApplyLayers, "falling pixel trail kept per step /256")  \
+    X(sparkle_fade,   uint8_t,  180,               0, 255,  nullptr,         "finale sparkle fade per frame /256")      \
+    X(beam_fade,      uint8_t,  200,               0, 255,  nullptr,         "finale beam fade per frame /256")         \
+    X(end_fade,       uint8_t,  120,               0, 255,  nullptr,         "finale closing fade per frame /256")      \
+    X(aurora_scale,   uint8_t,  70,                8, 255,  nullptr,         "Aurora noise units per pixel")
+
+#define TUNE(name) tune_##name      // current value - a plain global read
+
+#define TUNE_DECLARE(name, type, def, min, max, apply, help) extern type tune_##name;
+TUNABLES(TUNE_DECLARE)
+#undef TUNE_DECLARE
+
+// ==================== Registry ====================
+#define TUNE_NAMESPACE "luma-tune"  // NVS namespace, one key per tunable
+
+void Tune_ApplyOutput();            // Hands brightness, white balance, dithering and the power budget to the output stage
+void Tune_ApplyLayers();            // Hands the fades to the compositor layer persistence
+
+void Tune_Load();                   // Opens NVS, reads the stored values, then applies everything - call from setup() (NVS allocates)
+void Tune_Command(const char *args);    // Console command "set" - list | <name> <value> | save | defaults
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file vm.h
+ * @author sarvesh
+ * @brief Animation bytecode interpreter
+ * Small stack machine for effects that are uploaded over the serial console instead of flashed.
+ * Programs are verified once when they are loaded (opcodes, operands, jump targets and stack depth),
+ * so the interpreter itself runs without bounds checks from a precomputed dispatch table. Everything
+ * lives in fixed size statics - program, stack and registers - and the program is kept in flash (NVS).
+ * Only built with LUMA_FEATURE_SCRIPT
+ * @version 1.0
+ * @date 2026-2-24
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef VM_H
+#define VM_H
+
+#include "stdint.h"
+
+// ==================== Limits ====================
+#define VM_PROGRAM_MAX  512     // header + code bytes
+#define VM_STACK        16      // operand stack depth (int32)
+#define VM_REGS         16      // registers r0 - r15, kept between frames
+#define VM_STEP_LIMIT   4096    // backward jumps per frame before the frame is cut short
+#define VM_PUT_MAX      16      // bytes per "vm put" line -> fits CONSOLE_LINE_MAX as hex
+
+// ==================== Program Format ====================
+// [ 'L' 'V' version periodMs ] code... | jump targets are code offsets, little endian
+#define VM_MAGIC0   'L'
+#define VM_MAGIC1   'V'
+#define VM_VERSION  1
+#define VM_HEADER   4
+
+// ==================== Instruction Set ====================
+// Stack effect in brackets (before -- after). Values are int32, colors are perceptual 0-255 like ColorHSV.
+// The numbering is the file format - only append, and keep scripts/vm_asm.py in sync
+enum VmOp {
+    VM_HALT,        // ( -- )               ends the frame
+    VM_PUSH8,       // ( -- n )             signed 8-bit immediate
+    VM_PUSH16,      // ( -- n )             signed 16-bit immediate
+    VM_LOAD,        // ( -- r[i] )          register index immediate
+    VM_STORE,       // ( n -- )             register index immediate
+    VM_DUP,         // ( a -- a a )
+    VM_DROP,        // ( a -- )
+    VM_SWAP,        // ( a b -- b a )
+    VM_OVER,        // ( a b -- a b a )
+    VM_ADD,         // ( a b -- a+b )
+    VM_SUB,         // ( a b -- a-b )
+    VM_MUL,         // ( a b -- a*b )
+    VM_DIV,         // ( a b -- a/b )       0 if b is 0
+    VM_MOD,         // ( a b -- a%b )       0 if b is 0
+    VM_MULFX,       // ( a b -- a*b>>8 )    8.8 fixed point multiply
+    VM_NEG,         // ( a -- -a )
+    VM_ABS,         // ( a -- |a| )
+    VM_AND,         // ( a b -- a&b )
+    VM_OR,          // ( a b -- a|b )
+    VM_XOR,         // ( a b -- a^b )
+    VM_SHL,         // ( a b -- a<<b )
+    VM_SHR,         // ( a b -- a>>b )      arithmetic
+    VM_LT,          // ( a b -- a<b )
+    VM_GT,          // ( a b -- a>b )
+    VM_EQ,          // ( a b -- a==b )
+    VM_NOT,         // ( a -- !a )
+    VM_JMP,         // ( -- )               16-bit target immediate
+    VM_JZ,          // ( a -- )             jump if a == 0
+    VM_JNZ,         // ( a -- )             jump if a != 0
+    VM_SIN,         // ( a -- sine8(a) )    0-255 wave, period 256
+    VM_RAND,        // ( n -- random(n) )
+    VM_TIME,        // ( -- ms )            since the program started
+    VM_FRAME,       // ( -- n )             frames run since the program started
+    VM_BTN,         // ( -- bits )          VmButton events since the last frame
+    VM_HSV,         // ( h s v -- )         pen color
+    VM_RGB,         // ( r g b -- )         pen color
+    VM_SET,         // ( x y -- )           one pixel in the pen color
+    VM_FADE,        // ( n -- )             scales the whole frame by n/256
+    VM_CLEAR,       // ( -- )
+    VM_RING,        // ( x y r -- )         pixels at manhattan distance r
+    VM_LINE,        // ( x0 y0 x1 y1 -- )
+    VM_OP_COUNT
+};
+
+enum VmButton {             // bits pushed by VM_BTN
+    VM_BUTTON_B_TAP  = 1,
+    VM_BUTTON_B_HOLD = 2,
+    VM_BUTTON_A_HOLD = 4    // A tap leaves the mode, so programs never see it
+};
+
+// ==================== Interpreter ====================
+void Vm_Init();                     // Loads the stored program from flash (or the built-in one), call from setup()
+void Vm_Start();                    // Restarts the program - registers, clock and its layer
+void Vm_Update();                   // Runs one frame into LAYER_SCRIPT when the program's period is due
+void Vm_Button(uint8_t events);     // Queues VmButton bits for the next frame
+
+void Vm_Command(const char *args);  // Console command "vm" - status, upload and reset
+
+#ifdef LUMA_BENCH
+void Vm_Benchmark();    // Prints the cost of the built-in program next to the native ColorFlood step
+#endif
+
+#endif
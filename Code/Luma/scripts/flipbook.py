@@ -0,0 +1,119 @@
+# Packs animated GIFs into a Luma flipbook image (see include/flipbook.h)
+#
+#   python scripts/flipbook.py boot=boot.gif logo=logo.gif -o flipbook.bin
+#   esptool.py --chip esp32c3 write_flash 0x290000 flipbook.bin    -> the "flipbook" partition in partitions.csv
+#
+# Every GIF must be 8x8. Its colors become the palette of the sequence (max 256), the first frame is a
+# keyframe and later frames are stored as deltas when that is smaller. Frame durations come from the GIF.
+# Needs Pillow.
+import argparse
+import struct
+import sys
+
+WIDTH = 8
+HEIGHT = 8
+NUM_LEDS = WIDTH * HEIGHT
+NAME_MAX = 8            # FLIPBOOK_NAME_MAX
+HOLD_MS = 10            # FLIPBOOK_HOLD_MS
+PARTITION_OFFSET = 0x290000
+PARTITION_SIZE = 0x100000
+
+FLIP_KEY, FLIP_DELTA, FLIP_LEVEL = 0, 1, 2
+
+
+def load_frames(path):
+    from PIL import Image, ImageSequence
+
+    gif = Image.open(path)
+    if gif.size != (WIDTH, HEIGHT):
+        sys.exit("%s: %dx%d, the matrix is %dx%d" % (path, gif.size[0], gif.size[1], WIDTH, HEIGHT))
+
+    frames = []
+    for frame in ImageSequence.Iterator(gif):
+        rgb = frame.convert("RGB")
+        pixels = [rgb.getpixel((i % WIDTH, i // WIDTH)) for i in range(NUM_LEDS)]    # pixelIndex(row, col)
+        frames.append((pixels, frame.info.get("duration", 100)))
+    return frames
+
+
+def pack_sequence(path, frame_ms, fade_out):
+    frames = load_frames(path)
+
+    palette = [(0, 0, 0)]               # index 0 is black, like the other palette effects
+    lookup = {(0, 0, 0): 0}
+    indexed = []
+    for pixels, duration in frames:
+        row = []
+        for color in pixels:
+            if color not in lookup:
+                if len(palette) == 256:
+                    sys.exit("%s: more than 256 colors" % path)
+                lookup[color] = len(palette)
+                palette.append(color)
+            row.append(lookup[color])
+        indexed.append((row, duration))
+
+    body = bytearray()
+    previous = None
+    for row, duration in indexed:
+        hold = min(255, max(1, round(duration / HOLD_MS)))
+        hold = 0 if hold * HOLD_MS == frame_ms else hold
+        changed = [i for i in range(NUM_LEDS) if previous is None or row[i] != previous[i]]
+        if previous is not None and len(changed) * 2 + 1 < NUM_LEDS:
+            body += bytes([FLIP_DELTA, hold, len(changed)])
+            for i in changed:
+                body += bytes([i, row[i]])
+        else:
+            body += bytes([FLIP_KEY, hold]) + bytes(row)
+        previous = row
+
+    for step in range(1, fade_out + 1):                    # palette level frames, 3 bytes each
+        body += bytes([FLIP_LEVEL, 0, 255 * (fade_out - step) // fade_out])
+
+    header = struct.pack("<HHHBB", len(indexed) + fade_out, frame_ms, len(palette), WIDTH, HEIGHT)
+    return header + b"".join(bytes(color) for color in palette) + body
+
+
+def pack_image(sequences):
+    directory_size = 12 + 16 * len(sequences)
+    entries = bytearray()
+    data = bytearray()
+    for name, blob in sequences:
+        entries += name.encode().ljust(NAME_MAX, b"\0")
+        entries += struct.pack("<II", directory_size + len(data), len(blob))
+        data += blob
+
+    length = directory_size + len(data)
+    return b"LFB1" + struct.pack("<IB3x", length, len(sequences)) + entries + data
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Luma flipbook packer")
+    parser.add_argument("sequences", nargs="+", metavar="name=file.gif")
+    parser.add_argument("-o", "--output", default="flipbook.bin")
+    parser.add_argument("--frame-ms", type=int, default=100, help="hold time of frames stored without their own")
+    parser.add_argument("--fade-out", type=int, default=0, metavar="FRAMES", help="fade every sequence to black at the end")
+    args = parser.parse_args()
+
+    sequences = []
+    for spec in args.sequences:
+        name, _, path = spec.partition("=")
+        if not path or len(name.encode()) > NAME_MAX:
+            sys.exit("%s: expected name=file.gif with a name of at most %d characters" % (spec, NAME_MAX))
+        sequences.append((name, pack_sequence(path, args.frame_ms, args.fade_out)))
+    if len(sequences) > 255:
+        sys.exit("at most 255 sequences")
+
+    image = pack_image(sequences)
+    if len(image) > PARTITION_SIZE:
+        sys.exit("%d bytes, the flipbook partition holds %d" % (len(image), PARTITION_SIZE))
+
+    with open(args.output, "wb") as out:
+        out.write(image)
+    for name, blob in sequences:
+        print("%-8s %6d bytes" % (name, len(blob)))
+    print("%s: %d bytes -> esptool.py --chip esp32c3 write_flash 0x%X %s" % (args.output, len(image), PARTITION_OFFSET, args.output))
+
+
+if __name__ == "__main__":
+    main()
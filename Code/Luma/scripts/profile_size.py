@@ -0,0 +1,14 @@
+# Prints the flash footprint of the build profile after every firmware build
+# (PlatformIO extra script, see extra_scripts in platformio.ini)
+import os
+
+Import("env")
+
+
+def report_size(source, target, env):
+    image = target[0].get_abspath()
+    size = os.path.getsize(image)
+    print("[PROFILE] %s : firmware.bin %d bytes (%.1f KB)" % (env["PIOENV"], size, size / 1024.0))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", report_size)
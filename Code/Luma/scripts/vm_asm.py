@@ -0,0 +1,132 @@
+# Assembler and uploader for the Luma animation VM (see include/vm.h)
+#
+#   python scripts/vm_asm.py effect.lasm                  -> prints the "vm" console lines to paste
+#   python scripts/vm_asm.py effect.lasm --port COM5      -> uploads over serial (needs pyserial)
+#   python scripts/vm_asm.py effect.lasm --c-array        -> C initializer (built-in program in vm.cpp)
+#
+# Source format: one instruction per line, "label:" defines a jump target, ";" starts a comment,
+# ".period <ms>" sets the frame period. "push <n>" picks the 8 or 16 bit form by itself.
+import argparse
+import sys
+
+# Same order as enum VmOp - this is the file format
+OPS = [
+    "halt", "push8", "push16", "load", "store", "dup", "drop", "swap", "over",
+    "add", "sub", "mul", "div", "mod", "mulfx", "neg", "abs",
+    "and", "or", "xor", "shl", "shr", "lt", "gt", "eq", "not",
+    "jmp", "jz", "jnz", "sin", "rand", "time", "frame", "btn",
+    "hsv", "rgb", "set", "fade", "clear", "ring", "line",
+]
+OPCODE = {name: i for i, name in enumerate(OPS)}
+REG_OPS = ("load", "store")
+JUMP_OPS = ("jmp", "jz", "jnz")
+
+PUT_MAX = 16    # VM_PUT_MAX
+
+
+def size_of(op, arg):
+    if op == "push":
+        return 2 if -128 <= arg <= 127 else 3
+    if op in REG_OPS or op == "push8":
+        return 2
+    if op in JUMP_OPS or op == "push16":
+        return 3
+    return 1
+
+
+def parse(path):
+    period = 20
+    lines = []
+    with open(path) as src:
+        for number, text in enumerate(src, 1):
+            text = text.split(";", 1)[0].strip()
+            if not text:
+                continue
+            while ":" in text:                              # one or more labels in front of the instruction
+                label, text = text.split(":", 1)
+                lines.append((number, "label", label.strip()))
+                text = text.strip()
+            if not text:
+                continue
+            words = text.split()
+            if words[0] == ".period":
+                period = int(words[1], 0)
+                continue
+            lines.append((number, words[0].lower(), words[1] if len(words) > 1 else None))
+    return period, lines
+
+
+def assemble(path):
+    period, lines = parse(path)
+
+    labels = {}
+    pc = 0
+    for number, op, arg in lines:                           # pass 1 - label addresses
+        if op == "label":
+            labels[arg] = pc
+        elif op == "push":
+            pc += size_of(op, int(arg, 0))
+        else:
+            pc += size_of(op, None)
+
+    code = bytearray()
+    for number, op, arg in lines:                           # pass 2 - bytes
+        if op == "label":
+            continue
+        if op == "push":
+            value = int(arg, 0)
+            op = "push8" if -128 <= value <= 127 else "push16"
+        if op not in OPCODE:
+            sys.exit("%s:%d: unknown instruction '%s'" % (path, number, op))
+        code.append(OPCODE[op])
+
+        if op == "push8":
+            code += int(arg, 0).to_bytes(1, "little", signed=True)
+        elif op == "push16":
+            code += int(arg, 0).to_bytes(2, "little", signed=True)
+        elif op in REG_OPS:
+            code.append(int(arg.lstrip("r"), 0))
+        elif op in JUMP_OPS:
+            if arg not in labels:
+                sys.exit("%s:%d: unknown label '%s'" % (path, number, arg))
+            code += labels[arg].to_bytes(2, "little")
+
+    return bytes(b"LV" + bytes([1, period]) + code)
+
+
+def console_lines(program):
+    yield "vm begin"
+    for offset in range(0, len(program), PUT_MAX):
+        yield "vm put %d %s" % (offset, program[offset:offset + PUT_MAX].hex())
+    yield "vm end"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Luma VM assembler")
+    parser.add_argument("source")
+    parser.add_argument("--port", help="serial port to upload to")
+    parser.add_argument("--c-array", action="store_true", help="print a C initializer")
+    args = parser.parse_args()
+
+    program = assemble(args.source)
+    print("; %d bytes" % len(program), file=sys.stderr)
+
+    if args.c_array:
+        for offset in range(0, len(program), 12):
+            print("    " + ", ".join("0x%02X" % b for b in program[offset:offset + 12]) + ",")
+    elif args.port:
+        import time
+        import serial
+        with serial.Serial(args.port, 115200, timeout=1) as port:
+            for line in console_lines(program):
+                port.write((line + "\n").encode())
+                time.sleep(0.05)                            # the console reads once per 20ms loop
+            time.sleep(0.5)
+            sys.stdout.write(port.read(port.in_waiting or 1).decode(errors="replace"))
+    else:
+        for line in console_lines(program):
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
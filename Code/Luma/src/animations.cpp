@@ -10,292 +10,405 @@
  */
 #include "animations.h"
 #include "ws2812b.h"
+#include "noise.h"
+#include "palette.h"
+#include "compositor.h"
+#include "timeline.h"
+#include "memstats.h"
+#include "clock.h"
+#include "tune.h"
+#include "trace.h"
+
+// ==================== Sub-pixel Drawing ====================
+/**
+ * @brief Adds a weighted color to one layer pixel, saturating at full drive
+ *
+ * @param weight 0 - 65536 (65536 -> the full color)
+ */
+static inline void depositPixel(LayerId target, int idx, const Rgb16 &color, uint32_t weight) {
+    Rgb16 p = Layer_GetPixel(target, idx);
+    uint32_t r = p.r + ((color.r * weight) >> 16);
+    uint32_t g = p.g + ((color.g * weight) >> 16);
+    uint32_t b = p.b + ((color.b * weight) >> 16);
+    Layer_SetPixel(target, idx, Rgb16{ (uint16_t)(r > 65535 ? 65535 : r),
+                                       (uint16_t)(g > 65535 ? 65535 : g),
+                                       (uint16_t)(b > 65535 ? 65535 : b) });
+}
+
+/**
+ * @brief Draws a point at a sub-pixel position
+ * The light is split over the 2x2 pixels around the point by how close it is to each of them (bilinear weights),
+ * layers are linear light so the total light stays the same wherever the point is and it glides instead of jumping.
+ * The point is added to what the layer already has, parts outside the matrix are dropped
+ *
+ * @param target Layer to draw into
+ * @param x Column, 8.8 sub-pixel - pixel centers are at whole numbers
+ * @param y Row, 8.8 sub-pixel
+ * @param color Full color of the point
+ */
+void drawSoftPoint(LayerId target, int16_t x, int16_t y, const Rgb16 &color) {
+    int col = x >> 8;               // arithmetic shift -> floor, also left of the matrix
+    int row = y >> 8;
+    uint32_t fx = x & 0xFF;         // how far towards the next column / row
+    uint32_t fy = y & 0xFF;
+
+    const uint32_t wx[2] = { SUBPIXEL - fx, fx };
+    const uint32_t wy[2] = { SUBPIXEL - fy, fy };
+
+    for (int dy = 0; dy < 2; dy++) {
+        int r = row + dy;
+        if (r < 0 || r >= HEIGHT || !wy[dy]) continue;
+
+        for (int dx = 0; dx < 2; dx++) {
+            int c = col + dx;
+            if (c < 0 || c >= WIDTH || !wx[dx]) continue;
+            depositPixel(target, pixelIndex(r, c), color, wx[dx] * wy[dy]);     // weights of the 4 pixels sum to 65536
+        }
+    }
+}
 
 // ==================== Screensaver Animation ====================
-static unsigned long explosionStart = 0;    // explosion start timer 
-static bool active = false;                 // explosion state running or not
-static int baseRow, baseCol;                // explosion origin coordinates
-static uint32_t explosionColor;             // color of the explosion
+#define ORB_MAX         TO_SUBPIXEL(CANVAS_WIDTH - 1)   // last cell center of the world the orb can reach
+#define ORB_MAX_ROW     TO_SUBPIXEL(CANVAS_HEIGHT - 1)
+
+#define STAR_COUNT      160     // ~2-3 stars in any window of the 64x64 world
 
 /**
- * @brief Starts pixel explosion at the given position 
+ * @brief Orb starts where the old whole-pixel orb started, drifting right at its speed (10 pixels per second)
+ * The camera starts in the top left corner of the world, so the first frames look like the matrix-sized saver
+ *
+ */
+void Orb_Init(Orb &orb, CanvasView &view) {
+    orb.x = 0;
+    orb.y = TO_SUBPIXEL(HEIGHT / 2);
+    orb.vx = TO_SUBPIXEL(10);
+    orb.vy = TO_SUBPIXEL(3);            // a little down as well, so it crosses the matrix instead of running along a row
+    orb.color = Color_HSV(40000, 255, 74);
+    orb.lastStep = Clock_Now();
+    CanvasView_Init(view, 0, 0);
+}
+
+/**
+ * @brief New random origin, direction and color after an explosion
+ * The origin is inside the window, so the new orb appears on the matrix instead of somewhere in the world
+ *
+ */
+void Orb_Respawn(Orb &orb, const CanvasView &view) {
+    orb.x = view.x + random(0, TO_SUBPIXEL(WIDTH - 1) + 1);
+    orb.y = view.y + random(0, TO_SUBPIXEL(HEIGHT - 1) + 1);
+    uint8_t fastest = TUNE(orb_speed);  // pixels per second per axis, the slowest orb is half as fast
+    orb.vx = TO_SUBPIXEL(random(fastest / 2, fastest + 1)) * (random(2) ? 1 : -1);
+    orb.vy = TO_SUBPIXEL(random(fastest / 2, fastest + 1)) * (random(2) ? 1 : -1) / 2;
+    orb.color = Color_HSV(random(0, 65535), 255, 74);
+    orb.lastStep = Clock_Now();
+}
+
+/**
+ * @brief Reflects a coordinate that left [0, max] back inside and turns the velocity around
+ *
+ */
+static inline void bounce(int32_t &p, int16_t &v, int32_t max) {
+    if (p < 0)   { p = -p;          v = -v; }
+    if (p > max) { p = 2 * max - p; v = -v; }
+}
+
+/**
+ * @brief Moves the orb by the time since the last call and draws it - runs every tick so it moves at the full frame rate
+ * The orb bounces off the edges of the world, the camera pans after it once it gets close to an edge of the matrix
+ *
+ * @param view Camera of the screensaver world
+ * @param target Layer of the screensaver, cleared every step
+ */
+void Orb_Update(Orb &orb, CanvasView &view, LayerId target) {
+    TRACE_SPAN("Orb_Update");
+    ClockMs now = Clock_Now();
+    int32_t dt = now - orb.lastStep;
+    orb.lastStep = now;
+    if (dt > 100) dt = 100;             // long stall (state was paused / left) -> no big jump
+
+    int32_t x = orb.x + (int32_t)orb.vx * dt / 1000;
+    int32_t y = orb.y + (int32_t)orb.vy * dt / 1000;
+    bounce(x, orb.vx, ORB_MAX);         // bounces off the edges of the world
+    bounce(y, orb.vy, ORB_MAX_ROW);
+    orb.x = x;
+    orb.y = y;
+    CanvasView_Follow(view, orb.x, orb.y, SAVER_MARGIN);
+
+    Layer_BeginFrame(target);
+    drawSoftPoint(target, orb.x - view.x, orb.y - view.y, orb.color);
+}
+
+/**
+ * @brief Fills the canvas with a dim starfield in three tints - the orb has something to drift past while the camera pans
+ * The canvas is one world for the whole firmware, like the palette and the layers : it is built once from setup()
+ * and only read afterwards, every device looks at it through the CanvasView in its own EffectContext
+ *
+ */
+void Saver_BuildWorld() {
+    Canvas_Clear();
+    Canvas_SetColor(1, Color_HSV(36000, 40, 40));      // cold white
+    Canvas_SetColor(2, Color_HSV(42000, 160, 34));     // blue
+    Canvas_SetColor(3, Color_HSV(6000, 140, 34));      // warm
+
+    for (int i = 0; i < STAR_COUNT; i++) {
+        Canvas_Set(random(0, CANVAS_WIDTH), random(0, CANVAS_HEIGHT), random(1, 4));
+    }
+}
+
+// Orb hit choreography : vibrate (anticipation) then explode - all the timing lives in these tables
+enum HitTrack { HIT_JITTER, HIT_SPARKS, HIT_VALUE };
+
+static const Keyframe HIT_JITTER_KEYS[] = {     // jitter radius of the orb
+    {   0, 1, EASE_LINEAR },                    // 3x3 micro anticipation jitter -1,0,1
+    { 300, 1, EASE_LINEAR },
+    { 300, 0, EASE_LINEAR }                     // orb is gone once it explodes
+};
+static const Keyframe HIT_SPARKS_KEYS[] = {     // sparks drawn per frame
+    {   0, 0, EASE_LINEAR },
+    { 300, 0, EASE_LINEAR },
+    { 300, 7, EASE_LINEAR },                    // explosion starts with 7 sparks per frame
+    { 800, 2, EASE_IN }                         // and thins out towards the end
+};
+static const Keyframe HIT_VALUE_KEYS[] = {      // spark brightness (perceptual Color_HSV value)
+    {   0, 79, EASE_LINEAR },
+    { 300, 79, EASE_LINEAR },
+    { 800, 52, EASE_IN }                        // sparks cool down as they fly
+};
+static const Track HIT_TRACKS[] = { TRACK(HIT_JITTER_KEYS), TRACK(HIT_SPARKS_KEYS), TRACK(HIT_VALUE_KEYS) };
+static const Timeline HIT_TIMELINE = TIMELINE(HIT_TRACKS);
+
+/**
+ * @brief Starts the orb hit at the given position
  * 
- * Locks the explosion origin, initializes the explosion timer & state 
- * and selects a random explosion color 
+ * Locks the origin, restarts the hit timeline and selects a random explosion color
  * 
- * @param row Row index of explosion origin
- * @param col Column index of explosion origin
+ * @param hit Hit to start
+ * @param orb Orb that was hit - position and color for the vibrate part
+ * @param view Camera of the world - it stands still during the hit, so the origin is kept in matrix coordinates
  */
-void startPixelExplosion(int row, int col) {
-    baseRow = row;
-    baseCol = col;
-    explosionStart = millis();
-    active = true;
-
-    explosionColor = matrix.ColorHSV(random(0, 65535), 255, 12);
+void startOrbHit(OrbHit &hit, const Orb &orb, const CanvasView &view) {
+    hit.x = orb.x - view.x;
+    hit.y = orb.y - view.y;
+    hit.orbColor = orb.color;
+    hit.start = Clock_Now();
+    hit.explosionHue = random(0, 65535);
+
+    Timeline_Start(hit.player, HIT_TIMELINE);
 }
 
 /**
- * @brief Checks if explosion is done
+ * @brief Checks if the orb hit is done
  * 
  * @return true if done
  * @return false if not done 
  */
-bool isExplosionDone() {
-    return !active;
+bool isOrbHitDone(const OrbHit &hit) {
+    return !hit.player.running;
 }
 
 /**
- * @brief If explosion is active then this function will update the explosion
+ * @brief Draws the current frame of the orb hit
  * 
+ * @param target Layer of the screensaver, cleared every step so the explosion is dominant
  */
-void updatePixelExplosion() {
-    if (!active) return;    // if explosion not active do nothing
+void updateOrbHit(OrbHit &hit, LayerId target) {
+    TRACE_SPAN("updateOrbHit");
+    if (!hit.player.running) return;    // if hit not active do nothing
 
-    unsigned long t = millis() - explosionStart;
+    Timeline_Tick(hit.player, Clock_Now() - hit.start);
 
-    matrix.clear();     // clearing matrix so explosion is dominant
+    Layer_BeginFrame(target);
 
-    if (t < 500) {      // explosion lasts ~500ms
-        // The main logic of explosion 
-        for (int i = 0; i < 7; i++) {   // draws 6 pixel spark per frame  and with this logic max the explosion can have 4x4 radius
-            int r = baseRow + random(-2, 2);    // -2 -1 0 1 -> 4x4 matrix
-            int c = baseCol + random(-2, 2);    // Increasing the range increases the matrix size
+    // Vibrate - micro jitter around the orb to build up for the explosion, sub-pixel so it shivers instead of hopping
+    int jitter = TO_SUBPIXEL(Timeline_Value(hit.player, HIT_JITTER));
+    if (jitter > 0) {
+        int16_t vx = hit.x + random(-jitter, jitter + 1);
+        int16_t vy = hit.y + random(-jitter, jitter + 1);
+        drawSoftPoint(target, vx, vy, hit.orbColor);    // parts outside the matrix are dropped
+    }
 
-            if (r >= 0 && r < HEIGHT && c >= 0 && c < WIDTH) {  // adding guards for r & c so they do not go out of range
-                matrix.setPixelColor(pixelIndex(r, c), explosionColor);
-            }
-        }
-    } else {
-        active = false; // clearing the active flag after explosion
+    // Explode - sparks around the origin, with this logic max the explosion can have 4x4 radius
+    int sparks = Timeline_Value(hit.player, HIT_SPARKS);
+    Rgb16 sparkColor = Color_HSV(hit.explosionHue, 255, Timeline_Value(hit.player, HIT_VALUE));
+
+    for (int i = 0; i < sparks; i++) {
+        int16_t x = hit.x + random(TO_SUBPIXEL(-2), TO_SUBPIXEL(2));    // -2 .. 2 pixels -> 4x4 area
+        int16_t y = hit.y + random(TO_SUBPIXEL(-2), TO_SUBPIXEL(2));    // Increasing the range increases the area
+        drawSoftPoint(target, x, y, sparkColor);
     }
-    matrix.show();  // displaying matrix
 }
 
  
 // ==================== Menu Preview - Color flood & Falling pixel ====================
+#if LUMA_FEATURE_COLOR_FLOOD
 /**
  * @brief Menu Preview animation for Color flood
  * 
  */
-void drawMenu_ColorFlood() {
-
-    static unsigned long lastUpdate = 0;    // stores when the last frame was drawn
-    static int radius = 0;                  // radius of expanding color flood
-
-    static int cx = random(0, WIDTH);       // center of ripple (x coordinate)
-    static int cy = random(0, HEIGHT);      // center of ripple (y coordinate)
-
-    static uint16_t baseHue = 0;            // base color
+void drawMenu_ColorFlood(FloodPreview &preview, LayerId target) {
 
     // frame rate control [animation fps control]
     // smaller value -> smoother & faster | larger value -> slower and choppy
-    if (millis() - lastUpdate < 55) return; // 1000ms / 55ms -> ~18FPS
+    if (Clock_Now() - preview.lastUpdate < TUNE(menu_flood_ms)) return;   // 1000ms / 55ms -> ~18FPS
 
-    lastUpdate = millis();  // updates the current time as the last frame time
+    preview.lastUpdate = Clock_Now();  // updates the current time as the last frame time
 
     // matrix.clear();  // Commented as i wanted the next color to overlap the current color 
 
-    uint32_t floodColor = matrix.ColorHSV(baseHue, 255, 90);    // Prepares the floor color for the flood
+    Rgb16 floodColor = Color_HSV(preview.baseHue, 255, 90);    // Prepares the floor color for the flood
 
     // Soft Ripple Effect - Slightly diming the current color before new color comes on
-    // Loops every pixel and extracts the color and dims the color before the new color is applied   
-    for (int i = 0; i < WIDTH * HEIGHT; i++) {  
-        uint32_t c = matrix.getPixelColor(i);
-
-        uint8_t r = (c >> 16) & 0xFF;
-        uint8_t g = (c >> 8) & 0xFF;
-        uint8_t b = c & 0xFF;
-
-        r = (r * 9) / 10;   // leds having 90% of its brightness
-        g = (g * 9) / 10;
-        b = (b * 9) / 10;
-
-        matrix.setPixelColor(i, r, g, b);
-    }
+    // The preview layer keeps ~90% of its brightness each step (see LAYER_MENU_FLOOD persistence)
+    Layer_BeginFrame(target);
 
     // Addig new color from random centers
     for (int y = 0; y < HEIGHT; y++) {  // loop over all the 64 leds
         for (int x = 0; x < WIDTH; x++) {
 
-            int dist = abs(x - cx) + abs(y - cy);   // calculating manhattan distance from center 
+            int dist = abs(x - preview.cx) + abs(y - preview.cy);   // calculating manhattan distance from center 
             // can use euclidean distance formula above to get circular expansion 
             // but since i have just 8x8 i did not choose circular expansion
             
             // radius at the begining will be 0 say origin is 3,3 so in first frame only 3,3 will lit up 
             // Next frame radius is 1 then the 4 pixel on each side of 3,3 will lit up and so on so forth..
             
-            if (dist <= radius) {   // only pixels within the current radius are affected in each frame | creating expanding effect
-                uint16_t hue = baseHue + dist * 200;    // pixels farther from center get slighter diff hues
-                floodColor = matrix.ColorHSV(hue,255,90);   
-                matrix.setPixelColor(pixelIndex(y, x), matrix.gamma32(floodColor)); // giving gradient / ripple color look
+            if (dist <= preview.radius) {   // only pixels within the current radius are affected in each frame | creating expanding effect
+                uint16_t hue = preview.baseHue + dist * TUNE(flood_hue);   // pixels farther from center get slighter diff hues
+                floodColor = Color_HSV(hue, 255, 90);
+                Layer_SetPixel(target, pixelIndex(y, x), floodColor); // giving gradient / ripple color look
             }
         }
     }
-    radius++;   // expand the radius for next frame
+    preview.radius++;   // expand the radius for next frame
 
-    if (radius > WIDTH + HEIGHT) {      // when ripple is done
-        radius = 0;                     // reset the radius
-        cx = random(0, WIDTH);          // pick random origin
-        cy = random(0, HEIGHT);
-        baseHue += 4000;                // gently shifting hue
+    if (preview.radius > WIDTH + HEIGHT) {      // when ripple is done
+        preview.radius = 0;                     // reset the radius
+        preview.cx = random(0, WIDTH);          // pick random origin
+        preview.cy = random(0, HEIGHT);
+        preview.baseHue += 4000;                // gently shifting hue
     }
-
-    matrix.show();
 }
+#endif
 
+#if LUMA_FEATURE_FALLING_PIXEL
 /**
  * @brief Menu Preview animation for Falling pixel
  * 
  */
-void drawMenu_FallingPixel() {
-
-    static unsigned long lastUpdate = 0;        // stores when the last frame was drawn
-    static unsigned long gravityPauseUntil = 0; // stores until what time the animation should pause
-
-    static int x1 = 0;                          // fixed row as the pixel will fall from top
-    static int y1 = random(0, 8);               // pixel can fall through random column
-    static uint32_t color1 = 0;                 // stores the pixel color
+void drawMenu_FallingPixel(FallPreview &preview, LayerId target) {
 
     // frame rate control [animation fps control]
     // smaller value -> smoother & faster | larger value -> slower and choppy
-    if (millis() - lastUpdate < 90) return; // 1000ms / 90ms -> ~11FPS
+    if (Clock_Now() - preview.lastUpdate < TUNE(menu_fall_ms)) return;    // 1000ms / 90ms -> ~11FPS
 
     // Gravity pause handling - adds a lil weight to the motion
-    if (millis() < gravityPauseUntil) return;
-
-    lastUpdate = millis();  // updates the current time as the last frame time
-
-    // Trail logic
-    for (int i = 0; i < 64; i++) {  // loop through all 64 leds each led fades a lil every frame
-        uint32_t c = matrix.getPixelColor(i);   // reads the color from pixel
-
-        // extracting rgb values from color
-        uint8_t r = (c >> 16) & 0xFF;
-        uint8_t g = (c >> 8) & 0xFF;
-        uint8_t b = c & 0xFF;
+    if (Clock_Now() < preview.gravityPauseUntil) return;
 
-        // adding exponential fading to it | Changing the below value will affect the trail brightness  
-        r = (r * 6) / 10;   // leds have 60% of brightness and loses 40% of brightness in each frame
-        g = (g * 6) / 10;
-        b = (b * 6) / 10;
+    preview.lastUpdate = Clock_Now();  // updates the current time as the last frame time
 
-        matrix.setPixelColor(i, r, g, b);  
-    }
+    // Trail logic - every led keeps 60% of its brightness each frame (see LAYER_MENU_FALL persistence)
+    Layer_BeginFrame(target);
 
-    matrix.setPixelColor(pixelIndex(x1, y1), matrix.gamma32(color1));
-    x1++;   // move pixel one row down
+    Layer_SetPixel(target, pixelIndex(preview.row, preview.col), preview.color);
+    preview.row++;   // move pixel one row down
 
     // Bottom detection & respawn 
-    if (x1 >= 8) {          // x1 = 8 means its at the bottom 
-        x1 = 0;             // again going back to top row
-        y1 = random(0, 8);  // random column chosen
+    if (preview.row >= HEIGHT) {            // at the bottom 
+        preview.row = 0;                    // again going back to top row
+        preview.col = random(0, WIDTH);     // random column chosen
 
-        color1 = matrix.ColorHSV(random(0, 65535), random(180, 255), random(50, 100));  // random color
-        gravityPauseUntil = millis() + random(40, 80); // pause animation when it hit the ground
+        preview.color = Color_HSV(random(0, 65535), random(180, 255), random(50, 100));  // random color
+        preview.gravityPauseUntil = Clock_Now() + random(40, 80); // pause animation when it hit the ground
     }
-
-    matrix.show();
 }
+#endif
 
+#if LUMA_FEATURE_AURORA
+static void Aurora_Render(AuroraContext &aurora, uint16_t scale, LayerId target);  // shared with the Aurora mode below
 
-// ==================== Color flood Interaction ====================
-
-#define MAX_FLOODS 5    // Limits the no: of simultaneous floods to prevent unexpected crashes/resets due to unknown memory access
+/**
+ * @brief Menu Preview animation for Aurora
+ * Slower and zoomed out version of the ambient mode, drawn into its own layer so it can keep
+ * running in the background while another option is selected (dimmed by the layer alpha)
+ */
+void drawMenu_Aurora(AuroraContext &aurora, LayerId target) {
+    if (Clock_Now() - aurora.previewUpdate < TUNE(menu_aurora_ms)) return;    // 1000ms / 40ms -> 25FPS is plenty for a preview
+    aurora.previewUpdate = Clock_Now();
 
-struct ColorFlood {     // Defines one color flood  
-    int cx;             // center of flood coordinates
-    int cy;             // center of flood coordinates
-    int radius;         // how far the flood expands
-    uint16_t baseHue;   // base color of the flood
-    bool active;        // is the flood active or not
-};
+    Aurora_Render(aurora, 90, target);
+}
+#endif
 
-static ColorFlood floods[MAX_FLOODS];   // pool of animation instances
-static unsigned long lastUpdate = 0;    // frame rate control for the flood
+#if LUMA_FEATURE_COLOR_FLOOD
+// ==================== Color flood Interaction ====================
 
 /**
  * @brief Prepares the matrix for color flood
  * clears all the flood states, clears the matrix 
  * 
  */
-void ColorFlood_Init() {
-    memset(floods, 0, sizeof(floods));
-    matrix.clear();
-    matrix.show();
+void ColorFlood_Init(ColorFloodContext &flood, LayerId target) {
+    memset(flood.floods, 0, sizeof(flood.floods));
+    Layer_Clear(target);
 }
 
 /**
  * @brief Spawns a new color flood 
  * 
  */
-void ColorFlood_StartNew() {
+void ColorFlood_StartNew(ColorFloodContext &flood) {
     for (int i = 0; i < MAX_FLOODS; i++) {          // iterates through all the 5 Flood slots 
-        if (!floods[i].active) {                    // uses the Flood active flag to check for empty slots
-            floods[i].cx = random(0, WIDTH);        // picks random column
-            floods[i].cy = random(0, HEIGHT);       // picks random row
-            floods[i].radius = 0;                   // starts flood as single pixel
-            floods[i].baseHue = random(65535);      // each flood gets random color
-            floods[i].active = true;                // setting the flag high
+        ColorFlood &f = flood.floods[i];
+        if (!f.active) {                            // uses the Flood active flag to check for empty slots
+            f.cx = random(0, WIDTH);                // picks random column
+            f.cy = random(0, HEIGHT);               // picks random row
+            f.radius = 0;                           // starts flood as single pixel
+            f.baseHue = random(65535);              // each flood gets random color
+            f.active = true;                        // setting the flag high
             break;
         }
     }
 }
 
-/**
- * @brief This is a helper function used in color flood interaction to slowly decay the flood after button presses
- * 
- * @param fadeAmount Controls how quicly pixels dim | Higher Value -> Slower Fade and vice versa
- */
-void fadeMatrix(uint8_t fadeAmount) {
-    for (int i = 0; i < 64; i++) {              // iterates to all the 64 leds
-        uint32_t c = matrix.getPixelColor(i);   // gets the color of the pixel
-
-        uint8_t r = (c >> 16) & 0xFF;           // extracting indivual colors using bit masking
-        uint8_t g = (c >> 8)  & 0xFF;
-        uint8_t b = c & 0xFF;
-
-        /* scale brightness down | acts as fixed point brightness multiplier
-           fadeAmount value ranges from 0 - 255 and wth >> 8 the overall gets divided by 256
-           so with fadeamount value 255 the multiplier to r,g,b value is 255/256 = 0.996 which is like almost 
-           no fade. So with lower value say like 128 the multiplier is 128/256 = 0.5 so directly 
-           50% brightness value is lost with each frame.
-        */ 
-        r = (r * fadeAmount) >> 8;
-        g = (g * fadeAmount) >> 8;
-        b = (b * fadeAmount) >> 8;
-
-        matrix.setPixelColor(i, r, g, b);
-    }
-}
 
 /**
  * @brief Animation engine for the flood
  * 
  */
-void ColorFlood_Update() {
+void ColorFlood_Update(ColorFloodContext &flood, LayerId target) {
+    TRACE_SPAN("ColorFlood_Update");
 
     // frame rate control - currently set at 1000/55 -> ~18 FPS
-    if (millis() - lastUpdate < 55) return;
-    lastUpdate = millis();
+    if (Clock_Now() - flood.lastUpdate < TUNE(flood_ms)) return;
+    flood.lastUpdate = Clock_Now();
+
+    ColorFlood_Step(flood, target);
+}
+
+/**
+ * @brief One step of the flood animation without the frame rate control
+ * Kept separate so the benchmarks can time exactly one step
+ * 
+ */
+void ColorFlood_Step(ColorFloodContext &flood, LayerId target) {
 
     // gentle decay so old floods fade
-    fadeMatrix(230);   // 230/256 = ~0.90 means with each frame it will lose 10% of it brightness.
+    Layer_BeginFrame(target);   // flood layer persists at 230/256 = ~0.90 means with each frame it will lose 10% of it brightness.
 
     // render all active floods
     for (int i = 0; i < MAX_FLOODS; i++) {
-        if (!floods[i].active) continue;    // inactive floods are skipped
+        if (!flood.floods[i].active) continue;  // inactive floods are skipped
 
-        ColorFlood &f = floods[i];  
+        ColorFlood &f = flood.floods[i];  
 
         for (int y = 0; y < HEIGHT; y++) {                      // iterating over all the leds
             for (int x = 0; x < WIDTH; x++) {
 
                 int dist = abs(x - f.cx) + abs(y - f.cy);       // using manhattan distance formula
                 if (dist <= f.radius) {                         // pixels inside the radius will be affected
-                    uint16_t hue = f.baseHue + dist * 200;      // pixels further from center will have slightly diff hues
-                    uint32_t c = matrix.gamma32(matrix.ColorHSV(hue, 255, 90)); 
-                    matrix.setPixelColor(pixelIndex(y, x), c);
+                    uint16_t hue = f.baseHue + dist * TUNE(flood_hue);     // pixels further from center will have slightly diff hues
+                    Rgb16 c = Color_HSV(hue, 255, 90);
+                    Layer_SetPixel(target, pixelIndex(y, x), c);
                 }
             }
         }
@@ -304,38 +417,35 @@ void ColorFlood_Update() {
         // when floods covers the matrix
         if (f.radius > WIDTH + HEIGHT) f.active = false;    // reset the flag -> makes the slot free
     }
-    matrix.show();
 }
 
  
-// ==================== Falling Pixels Interaction ====================
+#endif
 
-static uint32_t grid[HEIGHT][WIDTH];   // this is settled pixels, stores colors and if the place is occupied or not
-static uint8_t columnHeight[WIDTH];    // for each column how many pixels are stacked, is stored in this
-
-#define MAX_FALLING 8   // max simultaneous falling pixels
-
-typedef struct {    // Defines one falling pixel
-    bool active;    // if the pixel currently falling
-    int x;          // column
-    int y;          // row
-    uint32_t color; // RGB value
-} FallingPixel;
+#if LUMA_FEATURE_FALLING_PIXEL
+// ==================== Falling Pixels Interaction ====================
 
-static FallingPixel falling[MAX_FALLING];   // fixed falling limit no dynamic allocation   
+/**
+ * @brief Color of a falling / settled pixel - one hue byte per pixel is enough to store the whole board
+ *
+ */
+static inline Rgb16 settledColor(uint8_t hue) {
+    return Color_HSV(hue << 8, 200, 90);
+}
 
-static unsigned long lastFall = 0;  // used for frame timing
+static bool finaleStep(FallingPixelContext &fall, LayerId trail, LayerId settled);  // end sequence, see the finale below
 
 /**
  * @brief Initializes the Falling Pixel Interaction
  * 
  */
-void FallingPixel_Init() {                          // Initilization
-    memset(grid, 0, sizeof(grid));                  // clears settled pixels
-    memset(columnHeight, 0, sizeof(columnHeight));  // Resets all columns to empty
-    memset(falling, 0, sizeof(falling));            // Clears all active falling particles 
-    matrix.clear();
-    matrix.show();
+void FallingPixel_Init(FallingPixelContext &fall, LayerId trail, LayerId settled) {   // Initilization
+    memset(fall.grid, 0, sizeof(fall.grid));                    // clears settled pixels
+    memset(fall.columnHeight, 0, sizeof(fall.columnHeight));    // Resets all columns to empty
+    memset(fall.falling, 0, sizeof(fall.falling));              // Clears all active falling particles 
+    Coro_Stop(fall.finale.coro);                                // a finale in progress ends with the board
+    Layer_Clear(trail);
+    Layer_Clear(settled);
 }
 
 /**
@@ -345,8 +455,8 @@ void FallingPixel_Init() {                          // Initilization
  * @return true ,if the column is full
  * @return false , if the column is not fully stacked
  */
-bool isColumnFull(uint8_t col) {    // this is done to prevent crashes    
-    return columnHeight[col] >= HEIGHT; // If column height already as HEIGHT (8) pixels then it cannot accept more
+static bool isColumnFull(const FallingPixelContext &fall, uint8_t col) {   // this is done to prevent crashes    
+    return fall.columnHeight[col] >= HEIGHT;    // If column height already as HEIGHT (8) pixels then it cannot accept more
 }
 
 /**
@@ -354,7 +464,8 @@ bool isColumnFull(uint8_t col) {    // this is done to prevent crashes
  * 
  * @param count for short press 1 and long press drops 8-10 
  */
-void FallingPixel_Spawn(uint8_t count) {    
+void FallingPixel_Spawn(FallingPixelContext &fall, uint8_t count) {    
+    if (Coro_Running(fall.finale.coro)) return;     // the board only empties by beaming out during the finale
 
     bool colUsed[WIDTH] = { false };   // prevents long press pixels to fall into same column spawns
 
@@ -362,7 +473,7 @@ void FallingPixel_Spawn(uint8_t count) {
 
         int slot = -1;    // represents empty falling slot 
         for (int k = 0; k < MAX_FALLING; k++) {     // Loops through 8 columns to find the inactive column
-            if (!falling[k].active) {
+            if (!fall.falling[k].active) {
                 slot = k;                           // slot gets that column value
                 break;
             }
@@ -374,7 +485,7 @@ void FallingPixel_Spawn(uint8_t count) {
         uint8_t validCount = 0;
 
         for (uint8_t col = 0; col < WIDTH; col++) {     // loops through 8 columns to check which columns are not full or have not been used in this spawn batch
-            if (!isColumnFull(col) && !colUsed[col]) {
+            if (!isColumnFull(fall, col) && !colUsed[col]) {
                 validCols[validCount++] = col;
             }
         }
@@ -384,10 +495,12 @@ void FallingPixel_Spawn(uint8_t count) {
         uint8_t col = validCols[random(validCount)];    // picks random column
         colUsed[col] = true;    // marks it as used so next pixel cannot use it
 
-        falling[slot].active = true;    // activate pixel
-        falling[slot].x = col;          // start spawning from the column
-        falling[slot].y = 0;            // of top row
-        falling[slot].color = matrix.gamma32(matrix.ColorHSV(random(65535), 200, 90));  // random colors
+        FallingPixel &p = fall.falling[slot];
+        p.active = true;                // activate pixel
+        p.x = col;                      // start spawning from the column
+        p.y = 0;                        // of top row
+        p.hue = random(256);            // random colors
+        p.color = settledColor(p.hue);
     }
 }
 
@@ -395,54 +508,53 @@ void FallingPixel_Spawn(uint8_t count) {
  * @brief Animation Engine of Falling Pixel Interaction
  * 
  */
-void FallingPixel_Update() {
+void FallingPixel_Update(FallingPixelContext &fall, LayerId trail, LayerId settled) {
+    TRACE_SPAN("FallingPixel_Update");
+
+    if (Coro_Running(fall.finale.coro)) {   // the finale replaces the physics until the board is empty
+        TRACE_SPAN("FallingPixel_Finale");
+        finaleStep(fall, trail, settled);
+        return;
+    }
 
     // this controls the fall speed FPS
-    if (millis() - lastFall < 25) return;   // 1000ms / 25ms = 40FPS
-    lastFall = millis();
+    if (Clock_Now() - fall.lastFall < TUNE(fall_ms)) return;   // 1000ms / 25ms = 40FPS
+    fall.lastFall = Clock_Now();
 
     // ---------- UPDATE PHYSICS ----------
     for (int i = 0; i < MAX_FALLING; i++) {
-        if (!falling[i].active) continue;   // processing only the active pixels which is updated spawn function
+        FallingPixel &p = fall.falling[i];
+        if (!p.active) continue;    // processing only the active pixels which is updated spawn function
 
-        int x = falling[i].x;
-        int y = falling[i].y;
-        int stackTop = HEIGHT - columnHeight[x] - 1;    // calculates where pixel should stop 
+        int x = p.x;
+        int y = p.y;
+        uint8_t &height = fall.columnHeight[x];
+        int stackTop = HEIGHT - height - 1;     // calculates where pixel should stop 
 
         if (y >= stackTop) {    // Pixels have reached the stack 
-            if (columnHeight[x] < HEIGHT) {                
-                grid[columnHeight[x]][x] = falling[i].color;    // saves pixel into settled grid
-                columnHeight[x]++;                              // increase stack height
+            if (height < HEIGHT) {                
+                fall.grid[height][x] = p.hue;   // saves pixel into settled grid
+                Layer_SetPixel(settled, pixelIndex(HEIGHT - 1 - height, x), p.color);  // drawn once when it settles
+                height++;                       // increase stack height
             }
-            falling[i].active = false;  // deactivate falling
+            p.active = false;   // deactivate falling
         } else {
-            falling[i].y++; // continue falling
+            p.y++;              // continue falling
         }
     }
 
     // ---------- RENDER ----------
     // matrix.clear();  // This was clearing the matrix with each frame everything was blinking leds falling
-    fadeMatrix(150);    // replacing clear with fade 
-
-    // draw settled grid - later need to add something to make this alive
-    for (int x = 0; x < WIDTH; x++) {
-        for (int y = 0; y < columnHeight[x]; y++) {
-
-            uint32_t c = grid[y][x];
-            uint8_t r = (c >> 16) & 0xFF;
-            uint8_t g = (c >> 8)  & 0xFF;
-            uint8_t b = c & 0xFF;
+    Layer_BeginFrame(trail);    // replacing clear with fade - trail layer persists at 150/256
 
-            matrix.setPixelColor(pixelIndex(HEIGHT - 1 - y, x),r, g, b);
-        }
-    }
+    // settled grid lives in its own persistent layer and is composited on top of the trails - later need to add something to make this alive
     // draw falling pixels
     for (int i = 0; i < MAX_FALLING; i++) {
-        if (falling[i].active) {
-            matrix.setPixelColor( pixelIndex(falling[i].y, falling[i].x), falling[i].color);
+        const FallingPixel &p = fall.falling[i];
+        if (p.active) {
+            Layer_SetPixel(trail, pixelIndex(p.y, p.x), p.color);
         }
     }
-    matrix.show();
 }
 
 /**
@@ -451,121 +563,260 @@ void FallingPixel_Update() {
  * @return true if full
  * @return false if not full
  */
-bool FallingPixel_IsFull() {     
+bool FallingPixel_IsFull(const FallingPixelContext &fall) {     
     for (int x = 0; x < WIDTH; x++) {
-        if (columnHeight[x] < HEIGHT) return false; // if any column is not full means grid not full
+        if (fall.columnHeight[x] < HEIGHT) return false; // if any column is not full means grid not full
     }
     return true;
 }
 
 /**
- * @brief This is the Anticipation Part before the beaming out 
- * Can work on this more better
- * @param durationMs How much you want the anticipation part
+ * @brief Draws every settled pixel into the settled layer
+ *
  */
-void FallingPixel_WarningSparkle(uint16_t durationMs) {    
-    unsigned long start = millis();
-    uint8_t phase = 0;
+static void drawBoard(const FallingPixelContext &fall, LayerId settled) {
+    for (int x = 0; x < WIDTH; x++) {
+        for (int y = 0; y < fall.columnHeight[x]; y++) {
+            Layer_SetPixel(settled, pixelIndex(HEIGHT - 1 - y, x), settledColor(fall.grid[y][x]));
+        }
+    }
+}
 
-    while (millis() - start < durationMs) {
+/**
+ * @brief Packs the settled board for a snapshot - column heights as nibbles, then the hue of every settled pixel
+ * Pixels still falling are left out, they would have landed a moment later anyway
+ *
+ * @param out FALL_PACK_MAX bytes
+ * @return Bytes written
+ */
+uint8_t FallingPixel_Pack(const FallingPixelContext &fall, uint8_t *out) {
+    uint8_t length = 0;
+    for (int x = 0; x < WIDTH; x += 2) out[length++] = fall.columnHeight[x] | (fall.columnHeight[x + 1] << 4);
+    for (int x = 0; x < WIDTH; x++) {
+        for (int y = 0; y < fall.columnHeight[x]; y++) out[length++] = fall.grid[y][x];
+    }
+    return length;
+}
 
-        fadeMatrix(180);   // very gentle decay - light fade 
+/**
+ * @brief Restores a board packed by FallingPixel_Pack and redraws the settled layer
+ *
+ * @return false if the data does not describe a valid board (nothing is changed then)
+ */
+bool FallingPixel_Unpack(FallingPixelContext &fall, const uint8_t *in, uint8_t length, LayerId trail, LayerId settled) {
+    if (length < WIDTH / 2) return false;
 
-        for (int x = 0; x < WIDTH; x++) {               // traversing all columns
-            for (int y = 0; y < columnHeight[x]; y++) { // traversing all rows
+    int count = 0;
+    for (int x = 0; x < WIDTH; x++) {
+        uint8_t height = (in[x / 2] >> ((x & 1) * 4)) & 0x0F;
+        if (height > HEIGHT) return false;
+        count += height;
+    }
+    if (length != WIDTH / 2 + count) return false;
 
-                // retrieving colors
-                uint32_t c = grid[y][x];
-                uint8_t r = (c >> 16) & 0xFF;
-                uint8_t g = (c >> 8) & 0xFF;
-                uint8_t b = c & 0xFF;
+    FallingPixel_Init(fall, trail, settled);
+    const uint8_t *hue = in + WIDTH / 2;
+    for (int x = 0; x < WIDTH; x++) {
+        fall.columnHeight[x] = (in[x / 2] >> ((x & 1) * 4)) & 0x0F;
+        for (int y = 0; y < fall.columnHeight[x]; y++) fall.grid[y][x] = *hue++;
+    }
+    drawBoard(fall, settled);
+    return true;
+}
 
-                int8_t sparkle = (Adafruit_NeoPixel::sine8(phase + x*11 + y*17) >> 6) - 2;  // adding bit of shimmer
-                // adding a small sine based shimmer per pixel
+// ==================== Falling Pixel Finale ====================
+// The end sequence used to block the loop for ~13s with delays between frames. It is a coroutine now : the
+// three phases read top to bottom as before, but every step returns to the loop, so input, the console and the
+// other clocks keep running while it plays. It draws into the settled layer, the only layer it needs
 
-                r = constrain(r + sparkle, 0, 255);
-                g = constrain(g + sparkle, 0, 255);
-                b = constrain(b + sparkle, 0, 255);
+/**
+ * @brief Counts the pixels still on the board
+ *
+ */
+static int boardRemaining(const FallingPixelContext &fall) {
+    int remaining = 0;
+    for (int x = 0; x < WIDTH; x++) remaining += fall.columnHeight[x];
+    return remaining;
+}
 
-                matrix.setPixelColor(pixelIndex(HEIGHT - 1 - y, x), r, g, b);
-            }
+/**
+ * @brief This is the Anticipation Part before the beaming out - every settled pixel shimmers a few percent
+ * Can work on this more better
+ *
+ */
+static void drawSparkle(FallingPixelContext &fall, LayerId settled) {
+    Layer_Fade(settled, TUNE(sparkle_fade));    // very gentle decay - light fade
+
+    for (int x = 0; x < WIDTH; x++) {               // traversing all columns
+        for (int y = 0; y < fall.columnHeight[x]; y++) {    // traversing all rows
+            uint8_t shimmer = 255 - (Adafruit_NeoPixel::sine8(fall.finale.phase + x*11 + y*17) >> 4);    // small sine based shimmer per pixel
+            Layer_SetPixel(settled, pixelIndex(HEIGHT - 1 - y, x), Color_Scale(settledColor(fall.grid[y][x]), shimmer));
         }
-        // Advance animation smoothly
-        phase++;
-        matrix.show();
-        delay(30);
     }
+    fall.finale.phase++;    // Advance animation smoothly
 }
 
 /**
- * @brief This is the Decay part Explosion Pixels beaming out
- * 
+ * @brief One step of the end sequence : anticipation, destruction (pixels beaming out), closure (final fade)
+ *
+ * @return false once the sequence is over and the board is empty again
  */
-void FallingPixel_BeamClear() {     // Decay part pixel beaming out
+static bool finaleStep(FallingPixelContext &fall, LayerId trail, LayerId settled) {
+    FallFinale &finale = fall.finale;
+    CORO_BEGIN(finale.coro);
+
+    // ----- Anticipation Phase -----
+    finale.sparkleEnd = Clock_Now() + 5000;
+    finale.phase = 0;
+    while (Clock_Now() < finale.sparkleEnd) {
+        drawSparkle(fall, settled);
+        CORO_SLEEP_MS(finale.coro, 30);
+    }
 
-    int delayTime = 120;   // start slow decay initially
+    // ----- Destruction Phase -----
+    finale.pauseMs = 120;   // start slow decay initially
+    while (boardRemaining(fall)) {      // loop until the grid is empty
+        do {
+            finale.col = random(WIDTH);     // pick random non-empty column
+        } while (fall.columnHeight[finale.col] == 0);
+
+        // beam takes the top pixel of the column one row up with each frame
+        for (finale.row = HEIGHT - fall.columnHeight[finale.col]; finale.row >= 0; finale.row--) {
+            Layer_Fade(settled, TUNE(beam_fade));
+            Layer_SetPixel(settled, pixelIndex(finale.row, finale.col), settledColor(fall.grid[fall.columnHeight[finale.col] - 1][finale.col]));
+            CORO_SLEEP_MS(finale.coro, 20);
+        }
 
-    while (!FallingPixel_IsFull() || true) {    // loop until the grid is empty
+        fall.columnHeight[finale.col]--;    // remove pixel from grid
+        Layer_Clear(settled);               // redraw remaining pixels in the grid
+        drawBoard(fall, settled);
+        CORO_SLEEP_MS(finale.coro, finale.pauseMs);
 
-        int remaining = 0;  // count remaining pixels
-        for (int x = 0; x < WIDTH; x++) remaining += columnHeight[x];
-        if (remaining == 0) break;  // exit only when the grid is empty
+        if (finale.pauseMs > 20) finale.pauseMs -= 5;   // with each beam the pause shrinks and pixels move faster
+    }
 
-        // pick random non-empty column
-        int col;
-        do {
-            col = random(WIDTH);
-        } while (columnHeight[col] == 0);   // This will stop if the column is empty
-
-        int y = columnHeight[col] - 1;  // beam takes pixel one pixel above to the top with each frame
-        uint32_t color = grid[y][col];
-
-        // animate beam upward
-        for (int by = HEIGHT - 1 - y; by >= 0; by--) {  // taking the beam to the top most row
-            fadeMatrix(200);
-            matrix.setPixelColor(pixelIndex(by, col), color);
-            matrix.show();
-            delay(20);
-        }
+    // ----- Closure Phase -----
+    for (finale.step = 0; finale.step < 8; finale.step++) {     // This does the gradual Global Fade
+        Layer_Fade(settled, TUNE(end_fade));
+        CORO_SLEEP_MS(finale.coro, 60);
+    }
+    FallingPixel_Init(fall, trail, settled);    // Resets the Falling Pixel Interaction State to start again
 
-        // remove pixel from grid
-        columnHeight[col]--;
+    CORO_END(finale.coro);
+}
 
-        // redraw reamining pixel in the grid
-        matrix.clear();
-        for (int x = 0; x < WIDTH; x++) {
-            for (int yy = 0; yy < columnHeight[x]; yy++) {
-                matrix.setPixelColor(pixelIndex(HEIGHT - 1 - yy, x), grid[yy][x]);
-            }
-        }
-        matrix.show();
+/**
+ * @brief This is the High Level Animation End Sequence - starts it, FallingPixel_Update plays it a step per frame
+ * Pixels still falling are dropped and no new ones spawn until the board is empty again
+ *
+ */
+void FallingPixel_Explosion(FallingPixelContext &fall, LayerId trail) {
+    memset(fall.falling, 0, sizeof(fall.falling));
+    Layer_Clear(trail);
+    Coro_Start(fall.finale.coro);
+}
+
+bool FallingPixel_InFinale(const FallingPixelContext &fall) {
+    return Coro_Running(fall.finale.coro);
+}
+#endif
 
-        delay(delayTime);
+#if LUMA_FEATURE_AURORA
+// ==================== Aurora Ambient Mode ====================
 
-        if (delayTime > 20) delayTime -= 5; // with each iteration delayTime reduces and pixel moves fast
+#define AURORA_SPREAD  64       // hue units per palette step -> 64 * 255 ~ quarter of the color wheel
+#define AURORA_VALUE   90       // peak brightness of the curtains
+
+/**
+ * @brief Builds the aurora palette
+ * The palette is a triangle (dark -> bright -> dark) so it wraps seamlessly and can be cycled forever.
+ * Color_HSV now runs 256 times per hue change instead of 64 times per frame
+ */
+static void Aurora_BuildPalette(const AuroraContext &aurora) {
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        uint8_t t = (i < 128) ? i * 2 : (255 - i) * 2;                          // 0 -> 254 -> 0
+
+        uint16_t hue = aurora.hue + t * AURORA_SPREAD;                           // position in the hue band
+        uint8_t v = (uint16_t)(((uint16_t)t * t) >> 8) * AURORA_VALUE >> 8;     // squaring darkens the valleys -> light curtains on a dark sky
+
+        Palette_Set(i, Color_HSV(hue, 255, v));
     }
 }
 
 /**
- * @brief This is the soft closing final fade
- * 
+ * @brief Renders one frame of the noise field into the indexed framebuffer
+ * Every pixel takes one noise3D sample, time is the z axis so the field morphs instead of scrolling.
+ * The noise value is the palette index and the palette slowly rotates, so the curtains ripple through the field
+ *
+ * @param scale Noise units per pixel
+ * @param target LAYER_PALETTE for the indexed framebuffer, any RGB layer gets the expanded colors instead
  */
-void FallingPixel_FinalFade() {     
-    for (int i = 0; i < 8; i++) {   // This does the gradual Global Fade
-        fadeMatrix(120);
-        matrix.show();
-        delay(60);
+static void Aurora_Render(AuroraContext &aurora, uint16_t scale, LayerId target) {
+    if (Palette_Acquire(PALETTE_OWNER_AURORA)) Aurora_BuildPalette(aurora);   // someone else drew with the palette
+
+    ClockMs t = Clock_Now();
+    uint16_t z     = t >> 2;    // time axis -> ~1 cell per second
+    uint16_t drift = t >> 4;    // slow sideways drift so the curtains also flow
+
+    Palette_SetRotation(t >> 6);            // palette cycling ~16 entries per second
+
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            uint8_t n = noise3D(x * scale + drift, y * scale, z);
+
+            if (target == LAYER_PALETTE) Palette_SetPixel(pixelIndex(y, x), n);
+            else                         Layer_SetPixel(target, pixelIndex(y, x), Palette_Lookup(n));
+        }
     }
-    FallingPixel_Init();            //Resets the Falling Pixel Interaction State to start again
 }
 
 /**
- * @brief This is the High Level Animation End Sequence
- * 
+ * @brief Initializes the Aurora ambient mode
+ *
+ */
+void Aurora_Init(AuroraContext &aurora) {
+    if (Palette_Acquire(PALETTE_OWNER_AURORA)) Aurora_BuildPalette(aurora);
+    Palette_Clear();
+}
+
+/**
+ * @brief Moves the aurora to the next hue band
+ *
+ */
+void Aurora_NextHue(AuroraContext &aurora) {
+    aurora.hue += 12000;
+    Aurora_BuildPalette(aurora);
+}
+
+/**
+ * @brief Animation engine of the Aurora, runs every FSM tick (50 FPS)
+ *
+ */
+void Aurora_Update(AuroraContext &aurora) {
+    TRACE_SPAN("Aurora_Update");
+    Aurora_Render(aurora, TUNE(aurora_scale), LAYER_PALETTE);  // noise units per pixel | smaller -> bigger, smoother blobs
+}
+#endif
+
+// ==================== Effect Context ====================
+/**
+ * @brief Starting values of every effect - what the function statics used to be initialized with
+ *
  */
-void FallingPixel_Explosion() {
-    FallingPixel_WarningSparkle(5000);    // Anticipation Phase
-    FallingPixel_BeamClear();             // Destruction Phase
-    FallingPixel_FinalFade();             // Closure Phase
+void Effects_Init(EffectContext &effects) {
+    memset(&effects, 0, sizeof(effects));
+    Orb_Init(effects.orb, effects.view);
+#if LUMA_FEATURE_COLOR_FLOOD
+    effects.floodPreview.cx = random(0, WIDTH);     // center of the first preview ripple
+    effects.floodPreview.cy = random(0, HEIGHT);
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    effects.fallPreview.col = random(0, WIDTH);     // pixel can fall through random column
+#endif
+#if LUMA_FEATURE_AURORA
+    effects.aurora.hue = 24000;                     // start of the hue band (green - cyan - blue)
+#endif
 }
 
+// ==================== Memory Budget ====================
+static_assert(sizeof(EffectContext) <= MEM_BUDGET_ANIMATIONS, "EffectContext exceeds MEM_BUDGET_ANIMATIONS");
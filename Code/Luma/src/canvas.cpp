@@ -0,0 +1,203 @@
+/**
+ * @file canvas.cpp
+ * @author sarvesh
+ * @brief Implementation of canvas.h
+ * @version 1.0
+ * @date 2026-3-11
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "canvas.h"
+#include "memstats.h"
+#include "trace.h"
+
+static uint8_t cells[CANVAS_HEIGHT][CANVAS_WIDTH / 2];     // two 4-bit cells per byte, the even column is the low nibble
+static Rgb16 colors[CANVAS_COLORS];                         // linear light color per cell index, index 0 stays black
+static uint8_t tileCells[CANVAS_TILES_X * CANVAS_TILES_Y];  // lit cells per tile, 0 -> the tile is skipped while sampling
+static uint64_t dirtyTiles = ~0ULL;                         // tiles changed since the view last drew them
+
+static_assert(sizeof(cells) + sizeof(colors) + sizeof(tileCells) + sizeof(dirtyTiles) <= MEM_BUDGET_CANVAS, "canvas world exceeds MEM_BUDGET_CANVAS");
+
+// ==================== Helpers ====================
+static inline uint8_t tileOf(int x, int y) {
+    return (y / CANVAS_TILE) * CANVAS_TILES_X + x / CANVAS_TILE;
+}
+
+static inline uint8_t cellAt(int x, int y) {
+    return (cells[y][x >> 1] >> ((x & 1) * 4)) & 0x0F;
+}
+
+static inline int16_t clampView(int16_t p, int16_t max) {
+    return p < 0 ? 0 : (p > max ? max : p);
+}
+
+// ==================== World ====================
+/**
+ * @brief Sets every cell to index 0 (transparent)
+ *
+ */
+void Canvas_Clear() {
+    memset(cells, 0, sizeof(cells));
+    memset(tileCells, 0, sizeof(tileCells));
+    dirtyTiles = ~0ULL;
+}
+
+/**
+ * @brief Sets the color of one cell index
+ * Any tile can use the index, so every tile counts as changed - meant for setup, not per frame
+ *
+ * @param index 1 - 15, index 0 is always transparent
+ * @param color Linear light color
+ */
+void Canvas_SetColor(uint8_t index, const Rgb16 &color) {
+    if (index == 0 || index >= CANVAS_COLORS) return;
+    colors[index] = color;
+    dirtyTiles = ~0ULL;
+}
+
+/**
+ * @brief Writes one cell of the world
+ * Constant cost wherever the cell is - only its tile is marked, nothing is drawn until the tile is in view
+ *
+ * @param x Column 0 - CANVAS_WIDTH-1
+ * @param y Row 0 - CANVAS_HEIGHT-1
+ * @param index Color index 0 - 15
+ */
+void Canvas_Set(int x, int y, uint8_t index) {
+    if (x < 0 || x >= CANVAS_WIDTH || y < 0 || y >= CANVAS_HEIGHT) return;
+    index &= 0x0F;
+
+    uint8_t old = cellAt(x, y);
+    if (old == index) return;
+
+    uint8_t shift = (x & 1) * 4;
+    cells[y][x >> 1] = (cells[y][x >> 1] & ~(0x0F << shift)) | (index << shift);
+
+    uint8_t tile = tileOf(x, y);
+    tileCells[tile] += (index != 0) - (old != 0);
+    dirtyTiles |= 1ULL << tile;
+}
+
+/**
+ * @brief Reads one cell of the world
+ *
+ * @return Color index, 0 outside the world
+ */
+uint8_t Canvas_Get(int x, int y) {
+    if (x < 0 || x >= CANVAS_WIDTH || y < 0 || y >= CANVAS_HEIGHT) return 0;
+    return cellAt(x, y);
+}
+
+// ==================== Viewport ====================
+/**
+ * @brief Places the window, the next Canvas_Render always draws it
+ *
+ * @param x Top left corner, 8.8 sub-pixel
+ * @param y Top left corner, 8.8 sub-pixel
+ */
+void CanvasView_Init(CanvasView &view, int16_t x, int16_t y) {
+    view.shown = false;
+    CanvasView_MoveTo(view, x, y);
+}
+
+/**
+ * @brief Moves the window, clamped so it never shows anything outside the world
+ *
+ */
+void CanvasView_MoveTo(CanvasView &view, int16_t x, int16_t y) {
+    view.x = clampView(x, CANVAS_VIEW_MAX_X);
+    view.y = clampView(y, CANVAS_VIEW_MAX_Y);
+}
+
+/**
+ * @brief Camera that follows a point of the world
+ * The window only pans when the point comes closer than margin pixels to one of its edges, and then exactly as far
+ * as the point moved - a point gliding at sub-pixel positions pans the window just as smoothly
+ *
+ * @param x Point column in the world, 8.8 sub-pixel
+ * @param y Point row in the world, 8.8 sub-pixel
+ * @param margin Pixels kept between the point and the edges of the window
+ */
+void CanvasView_Follow(CanvasView &view, int16_t x, int16_t y, uint8_t margin) {
+    int16_t nearEdgeX = TO_CANVAS(margin), farEdgeX = TO_CANVAS(WIDTH - 1 - margin);
+    int16_t nearEdgeY = TO_CANVAS(margin), farEdgeY = TO_CANVAS(HEIGHT - 1 - margin);
+    int16_t vx = view.x, vy = view.y;
+
+    if (x - vx < nearEdgeX) vx = x - nearEdgeX;
+    if (x - vx > farEdgeX)  vx = x - farEdgeX;
+    if (y - vy < nearEdgeY) vy = y - nearEdgeY;
+    if (y - vy > farEdgeY)  vy = y - farEdgeY;
+
+    CanvasView_MoveTo(view, vx, vy);
+}
+
+/**
+ * @brief Draws the window into a layer
+ * Only the (WIDTH + 1) x (HEIGHT + 1) cells under the window are read, cells of empty tiles are not even looked at.
+ * Between whole pixels every LED mixes the 4 cells around it by how close it is to each of them (bilinear, linear light),
+ * so the world glides under a panning window instead of jumping a pixel at a time.
+ * Nothing is drawn if the window did not move and none of its tiles changed - the layer still holds it.
+ * Changes are tracked per world, not per view : a changed tile is redrawn by the next view that draws over it,
+ * other views looking at it only see the change once they move - the world is meant to be written from setup()
+ *
+ * @param view Window to draw
+ * @param target Persistent layer that keeps the window between draws
+ * @return true if the layer was drawn
+ */
+bool Canvas_Render(CanvasView &view, LayerId target) {
+    int col = view.x >> 8;
+    int row = view.y >> 8;
+    uint32_t fx = view.x & 0xFF;
+    uint32_t fy = view.y & 0xFF;
+
+    int lastCol = col + WIDTH - (fx ? 0 : 1);     // a whole-pixel window never reads the extra column / row
+    int lastRow = row + HEIGHT - (fy ? 0 : 1);
+
+    uint64_t tiles = 0;
+    for (int ty = row / CANVAS_TILE; ty <= lastRow / CANVAS_TILE; ty++) {
+        for (int tx = col / CANVAS_TILE; tx <= lastCol / CANVAS_TILE; tx++) {
+            tiles |= 1ULL << (ty * CANVAS_TILES_X + tx);
+        }
+    }
+
+    if (view.shown && view.shownX == view.x && view.shownY == view.y && !(dirtyTiles & tiles)) return false;
+    TRACE_SPAN("Canvas_Render");
+
+    uint8_t window[HEIGHT + 1][WIDTH + 1];          // cell indices under the window
+    for (int r = 0; r <= HEIGHT; r++) {
+        for (int c = 0; c <= WIDTH; c++) {
+            int x = col + c, y = row + r;
+            bool lit = x <= lastCol && y <= lastRow && tileCells[tileOf(x, y)];
+            window[r][c] = lit ? cellAt(x, y) : 0;
+        }
+    }
+
+    const uint32_t wx[2] = { 256 - fx, fx };
+    const uint32_t wy[2] = { 256 - fy, fy };
+
+    for (int r = 0; r < HEIGHT; r++) {
+        for (int c = 0; c < WIDTH; c++) {
+            uint32_t red = 0, green = 0, blue = 0;
+
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    uint32_t weight = wx[dx] * wy[dy];     // the 4 weights sum to 65536
+                    uint8_t index = window[r + dy][c + dx];
+                    if (!weight || !index) continue;
+
+                    red   += colors[index].r * weight >> 16;
+                    green += colors[index].g * weight >> 16;
+                    blue  += colors[index].b * weight >> 16;
+                }
+            }
+            Layer_SetPixel(target, pixelIndex(r, c), Rgb16{ (uint16_t)red, (uint16_t)green, (uint16_t)blue });
+        }
+    }
+
+    dirtyTiles &= ~tiles;
+    view.shownX = view.x;
+    view.shownY = view.y;
+    view.shown = true;
+    return true;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file clock.cpp
+ * @author sarvesh
+ * @brief Implementation of clock.h
+ * @version 1.0
+ * @date 2026-3-2
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "clock.h"
+#include "memstats.h"
+
+struct Clock {
+    ClockMs now;        // time of this clock
+    uint16_t scale;     // CLOCK_SCALE_ONE -> real time
+    uint8_t fraction;   // sub-millisecond rest of the scaled steps
+    bool paused;
+};
+
+static Clock clocks[CLOCK_COUNT] = {
+    { 0, CLOCK_SCALE_ONE, 0, false }, { 0, CLOCK_SCALE_ONE, 0, false },
+    { 0, CLOCK_SCALE_ONE, 0, false }, { 0, CLOCK_SCALE_ONE, 0, false },
+    { 0, CLOCK_SCALE_ONE, 0, false }, { 0, CLOCK_SCALE_ONE, 0, false },
+    { 0, CLOCK_SCALE_ONE, 0, false }, { 0, CLOCK_SCALE_ONE, 0, false }
+};
+static ClockMs uptime = 0;                      // unscaled 64-bit time
+static uint32_t lastSource = LUMA_CLOCK_START_MS;   // source value at the last advance
+static uint8_t selected = 0;                    // clock returned by Clock_Now()
+
+#ifdef LUMA_STRESS
+static uint32_t skipped = 0;                    // time added by Clock_Skip() without waiting for it
+#endif
+
+static_assert(sizeof(clocks) + sizeof(uptime) + sizeof(lastSource) + sizeof(selected)
+#ifdef LUMA_STRESS
+              + sizeof(skipped)
+#endif
+              <= MEM_BUDGET_CLOCK, "clock statics exceed MEM_BUDGET_CLOCK");
+
+// ==================== Time ====================
+/**
+ * @brief Current 32-bit source time - wraps, only the difference of two reads is used
+ *
+ */
+static inline uint32_t sourceMs() {
+    uint32_t source = (uint32_t)millis() + (uint32_t)LUMA_CLOCK_START_MS;
+#ifdef LUMA_STRESS
+    source += skipped;
+#endif
+    return source;
+}
+
+/**
+ * @brief Moves every clock by the source time passed since the last call
+ * Unsigned 32-bit difference -> correct across the millis() wraparound
+ */
+static void advance() {
+    uint32_t source = sourceMs();
+    uint32_t delta = source - lastSource;
+    lastSource = source;
+
+    uptime += delta;
+    for (uint8_t i = 0; i < CLOCK_COUNT; i++) {
+        if (clocks[i].paused) continue;
+        uint64_t scaled = (uint64_t)delta * clocks[i].scale + clocks[i].fraction;
+        clocks[i].now += scaled >> 8;
+        clocks[i].fraction = scaled & 0xFF;
+    }
+}
+
+ClockMs Clock_Now() {
+    return clocks[selected].now;
+}
+
+ClockMs Clock_Uptime() {
+    return uptime;
+}
+
+void Clock_Select(uint8_t id) {
+    if (id < CLOCK_COUNT) selected = id;
+}
+
+/**
+ * @brief Waits ms and brings every clock up to date
+ * Time only moves here - a frame sees one constant Clock_Now() from start to end
+ *
+ */
+void Clock_Delay(uint32_t ms) {
+    delay(ms);
+    advance();
+}
+
+#ifdef LUMA_STRESS
+/**
+ * @brief Advances every clock by ms right away - the frame delay of a stress run, which runs frames back to back
+ * The time the frames really take still passes on top, like on the device
+ *
+ */
+void Clock_Skip(uint32_t ms) {
+    skipped += ms;
+    advance();
+}
+
+/**
+ * @brief Every clock back to 0, running at real time - a fresh simulated device (stress runs)
+ *
+ */
+void Clock_Reset() {
+    advance();
+    for (uint8_t i = 0; i < CLOCK_COUNT; i++) {
+        clocks[i] = Clock{ 0, CLOCK_SCALE_ONE, 0, false };
+    }
+    uptime = 0;
+    selected = 0;
+}
+#endif
+
+// ==================== Per Clock Control ====================
+void Clock_Pause(uint8_t id) {
+    if (id < CLOCK_COUNT) clocks[id].paused = true;
+}
+
+void Clock_Resume(uint8_t id) {
+    if (id < CLOCK_COUNT) clocks[id].paused = false;
+}
+
+void Clock_SetScale(uint8_t id, uint16_t scale) {
+    if (id < CLOCK_COUNT) clocks[id].scale = scale;
+}
+
+// ==================== Console ====================
+/**
+ * @brief Console command "clock" - acts on the clock of the current state
+ * "clock" prints uptime and the clock, "clock pause" / "clock resume", "clock scale <percent>" (1 - 25500)
+ *
+ */
+void Clock_Command(const char *args) {
+    if (strcmp(args, "pause") == 0)  Clock_Pause(selected);
+    else if (strcmp(args, "resume") == 0) Clock_Resume(selected);
+    else if (strncmp(args, "scale", 5) == 0) {
+        long percent = atol(args + 5);
+        if (percent < 1 || percent > 25500) { Serial.println("clock: scale 1 - 25500 (percent)"); return; }
+        Clock_SetScale(selected, percent * CLOCK_SCALE_ONE / 100);
+    }
+    else if (*args) { Serial.println("clock: pause | resume | scale <percent>"); return; }
+
+    Serial.print("clock: uptime ");
+    Serial.print((uint32_t)(uptime / 1000));
+    Serial.print(" s | state clock ");
+    Serial.print(selected);
+    Serial.print(" at ");
+    Serial.print((uint32_t)(clocks[selected].now / 1000));
+    Serial.print(" s, ");
+    Serial.print((uint32_t)clocks[selected].scale * 100 / CLOCK_SCALE_ONE);
+    Serial.println(clocks[selected].paused ? "% (paused)" : "%");
+}
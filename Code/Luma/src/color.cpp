@@ -0,0 +1,69 @@
+/**
+ * @file color.cpp
+ * @author sarvesh
+ * @brief Implementation of color.h
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "color.h"
+#include "ws2812b.h"
+
+// ==================== Gamma Decode ====================
+// round(65535 * (i / 255) ^ 2.6) - same curve as the old per-pixel gamma32, but 16-bit so dark levels keep their steps
+static const uint16_t GAMMA_DECODE[256] = {
+        0,     0,     0,     1,     1,     2,     4,     6,     8,    11,    14,    18,
+       23,    29,    35,    41,    49,    57,    67,    77,    88,    99,   112,   126,
+      141,   156,   173,   191,   210,   230,   251,   274,   297,   322,   348,   375,
+      404,   433,   464,   497,   531,   566,   602,   640,   680,   721,   763,   807,
+      853,   899,   948,   998,  1050,  1103,  1158,  1215,  1273,  1333,  1394,  1458,
+     1523,  1590,  1658,  1729,  1801,  1875,  1951,  2029,  2109,  2190,  2274,  2359,
+     2446,  2536,  2627,  2720,  2816,  2913,  3012,  3114,  3217,  3323,  3431,  3541,
+     3653,  3767,  3883,  4001,  4122,  4245,  4370,  4498,  4627,  4759,  4893,  5030,
+     5169,  5310,  5453,  5599,  5747,  5898,  6051,  6206,  6364,  6525,  6688,  6853,
+     7021,  7191,  7364,  7539,  7717,  7897,  8080,  8266,  8454,  8645,  8838,  9034,
+     9233,  9434,  9638,  9845, 10055, 10267, 10482, 10699, 10920, 11143, 11369, 11598,
+    11829, 12064, 12301, 12541, 12784, 13030, 13279, 13530, 13785, 14042, 14303, 14566,
+    14832, 15102, 15374, 15649, 15928, 16209, 16493, 16781, 17071, 17365, 17661, 17961,
+    18264, 18570, 18879, 19191, 19507, 19825, 20147, 20472, 20800, 21131, 21466, 21804,
+    22145, 22489, 22837, 23188, 23542, 23899, 24260, 24625, 24992, 25363, 25737, 26115,
+    26496, 26880, 27268, 27659, 28054, 28452, 28854, 29259, 29667, 30079, 30495, 30914,
+    31337, 31763, 32192, 32626, 33062, 33503, 33947, 34394, 34846, 35300, 35759, 36221,
+    36687, 37156, 37629, 38106, 38586, 39071, 39558, 40050, 40545, 41045, 41547, 42054,
+    42565, 43079, 43597, 44119, 44644, 45174, 45707, 46245, 46786, 47331, 47880, 48432,
+    48989, 49550, 50114, 50683, 51255, 51832, 52412, 52996, 53585, 54177, 54773, 55374,
+    55978, 56587, 57199, 57816, 58436, 59061, 59690, 60323, 60960, 61601, 62246, 62896,
+    63549, 64207, 64869, 65535
+};
+
+/**
+ * @brief Decodes one perceptual channel value to linear light
+ *
+ * @param v Perceptual level 0-255
+ * @return uint16_t Linear level 0-65535
+ */
+uint16_t Color_Linearize(uint8_t v) {
+    return GAMMA_DECODE[v];
+}
+
+/**
+ * @brief Decodes a packed perceptual color to linear light
+ *
+ */
+Rgb16 Color_Hex(uint32_t rgb) {
+    return Rgb16{ GAMMA_DECODE[(rgb >> 16) & 0xFF], GAMMA_DECODE[(rgb >> 8) & 0xFF], GAMMA_DECODE[rgb & 0xFF] };
+}
+
+/**
+ * @brief HSV color in the linear working space
+ * Replaces gamma32(ColorHSV(...)) - the value is perceptual, so equal steps look equally bright
+ *
+ * @param hue 0-65535 color wheel
+ * @param sat 0-255
+ * @param val 0-255 perceptual brightness
+ */
+Rgb16 Color_HSV(uint16_t hue, uint8_t sat, uint8_t val) {
+    return Color_Hex(Adafruit_NeoPixel::ColorHSV(hue, sat, val));
+}
@@ -0,0 +1,318 @@
+/**
+ * @file compositor.cpp
+ * @author sarvesh
+ * @brief Implementation of compositor.h
+ * @version 1.0
+ * @date 2026-2-6
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "compositor.h"
+#include "ws2812b.h"
+#include "palette.h"
+#include "output.h"
+#include "memstats.h"
+#include "trace.h"
+
+// ==================== Layer Configuration ====================
+struct LayerConfig {
+    BlendMode mode;     // how the layer is blended onto the layers below
+    uint8_t persist;    // what Layer_BeginFrame does : 0 -> clear, 255 -> keep, else fade to persist / 256
+    uint8_t alpha;      // only used by BLEND_ALPHA
+};
+
+static LayerConfig config[LAYER_COUNT] = {     // persistence can be changed at runtime (tunables)
+    { BLEND_REPLACE, 255, 255 },    // LAYER_PALETTE      - owned by palette.cpp
+#if LUMA_FEATURE_COLOR_FLOOD
+    { BLEND_REPLACE, 230, 255 },    // LAYER_FLOOD        - ~10% decay per step so old floods fade
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    { BLEND_REPLACE, 150, 255 },    // LAYER_FALL_TRAIL   - short trail behind falling pixels
+    { BLEND_REPLACE, 255, 255 },    // LAYER_FALL_SETTLED - stacks stay until the finale clears them
+#endif
+#if LUMA_FEATURE_COLOR_FLOOD
+    { BLEND_REPLACE, 230, 255 },    // LAYER_MENU_FLOOD   - ~90% per step soft ripple
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    { BLEND_REPLACE, 154, 255 },    // LAYER_MENU_FALL    - ~60% per step trail
+#endif
+#if LUMA_FEATURE_SCRIPT
+    { BLEND_REPLACE, 255, 255 },    // LAYER_SCRIPT       - the program fades it itself (VM_FADE)
+#endif
+#if LUMA_FEATURE_AURORA
+    { BLEND_ALPHA,   255, 170 },    // LAYER_MENU_AURORA  - fully redrawn every step, alpha over black runs it at ~2/3 brightness
+#endif
+    { BLEND_REPLACE, 255, 255 },    // LAYER_WORLD        - Canvas_Render redraws the whole window when it has to
+    { BLEND_ADD,     0,   255 },    // LAYER_SAVER        - redrawn every step, adds light over anything below
+    { BLEND_REPLACE, 0,   255 }     // LAYER_TEXT         - redrawn whenever the label scrolls, crisp over the preview
+};
+
+static Rgb16 layers[LAYER_COUNT - 1][NUM_LEDS];     // linear light layers, the palette layer reads the indexed framebuffer instead
+#define PIXELS(id) layers[(id) - 1]                 // LAYER_PALETTE is the first id and has no slot
+
+static uint16_t dirtyMask = 0;      // layers changed since they were last composited
+static uint16_t lastMask = 0;       // layers of the last composite -> a different set always recomposites
+static Rgb16 outFrame[NUM_LEDS];    // composited frame handed to the output stage
+
+// ==================== Helpers ====================
+/**
+ * @brief Saturating add of two linear channels
+ *
+ */
+static inline uint16_t addChannel(uint16_t a, uint16_t b) {
+    uint32_t sum = (uint32_t)a + b;
+    return sum > 65535 ? 65535 : sum;
+}
+
+/**
+ * @brief Blends one layer pixel onto the composited color below it
+ * Linear light, so ADD and ALPHA mix the actual light of the two layers
+ *
+ */
+static inline Rgb16 blend(const Rgb16 &below, const Rgb16 &c, const LayerConfig &cfg) {
+    switch (cfg.mode) {
+        case BLEND_REPLACE:
+            return c;
+
+        case BLEND_ADD:
+            return Rgb16{ addChannel(below.r, c.r), addChannel(below.g, c.g), addChannel(below.b, c.b) };
+
+        case BLEND_MAX:
+            return Rgb16{ below.r > c.r ? below.r : c.r,
+                          below.g > c.g ? below.g : c.g,
+                          below.b > c.b ? below.b : c.b };
+
+        case BLEND_ALPHA: {
+            Rgb16 a = Color_Scale(below, 255 - cfg.alpha);     // the two weights sum to < 256 so channels never overflow
+            Rgb16 b = Color_Scale(c, cfg.alpha);
+            return Rgb16{ (uint16_t)(a.r + b.r), (uint16_t)(a.g + b.g), (uint16_t)(a.b + b.b) };
+        }
+
+        default:
+            return c;
+    }
+}
+
+// ==================== Layers ====================
+/**
+ * @brief Applies the layer persistence before an effect draws its next step
+ * Clear, keep or fade depending on the layer configuration
+ *
+ * @param id Layer the effect is about to draw into
+ */
+void Layer_BeginFrame(LayerId id) {
+    if (id == LAYER_PALETTE) return;
+
+    uint8_t persist = config[id].persist;
+    if (persist == 255) return;                     // persistent layer, nothing to do
+
+    if (persist == 0) {
+        memset(PIXELS(id), 0, sizeof(PIXELS(id)));
+        dirtyMask |= LAYER_BIT(id);
+    } else {
+        Layer_Fade(id, persist);
+    }
+}
+
+/**
+ * @brief Scales every pixel of the layer by scale / 256
+ * For effects that pick their own fade per step instead of the layer persistence
+ *
+ */
+void Layer_Fade(LayerId id, uint8_t scale) {
+    if (id == LAYER_PALETTE) return;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        if (!Color_IsBlack(PIXELS(id)[i])) PIXELS(id)[i] = Color_Scale(PIXELS(id)[i], scale);
+    }
+    dirtyMask |= LAYER_BIT(id);
+}
+
+/**
+ * @brief Clears the layer to transparent
+ *
+ */
+void Layer_Clear(LayerId id) {
+    if (id == LAYER_PALETTE) return;
+
+    memset(PIXELS(id), 0, sizeof(PIXELS(id)));
+    dirtyMask |= LAYER_BIT(id);
+}
+
+/**
+ * @brief Draws one pixel into the layer
+ *
+ * @param id Layer to draw into
+ * @param idx Linear pixel index from pixelIndex()
+ * @param color Linear light color, black is transparent
+ */
+void Layer_SetPixel(LayerId id, int idx, const Rgb16 &color) {
+    if (id == LAYER_PALETTE) return;
+
+    PIXELS(id)[idx] = color;
+    dirtyMask |= LAYER_BIT(id);
+}
+
+/**
+ * @brief Changes what Layer_BeginFrame does with the layer
+ *
+ * @param persist 0 -> clear, 255 -> keep, else fade to persist / 256
+ */
+void Layer_SetPersistence(LayerId id, uint8_t persist) {
+    config[id].persist = persist;
+}
+
+/**
+ * @brief Reads one pixel back from the layer
+ *
+ */
+Rgb16 Layer_GetPixel(LayerId id, int idx) {
+    if (id == LAYER_PALETTE) return RGB16_BLACK;
+    return PIXELS(id)[idx];
+}
+
+// ==================== Render Targets ====================
+static RenderTarget targetPool[RENDER_TARGET_POOL];    // preallocated offscreen frames
+
+static_assert(sizeof(config) + sizeof(layers) + sizeof(outFrame) + sizeof(targetPool) <= MEM_BUDGET_COMPOSITOR, "compositor layers and render targets exceed MEM_BUDGET_COMPOSITOR");
+
+/**
+ * @brief Takes a free render target from the pool
+ *
+ * @return RenderTarget* free target, or nullptr when all of them are in use
+ */
+RenderTarget *RenderTarget_Acquire() {
+    for (int i = 0; i < RENDER_TARGET_POOL; i++) {
+        if (!targetPool[i].inUse) {
+            targetPool[i].inUse = true;
+            return &targetPool[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Gives a render target back to the pool
+ *
+ */
+void RenderTarget_Release(RenderTarget *target) {
+    if (target) target->inUse = false;
+}
+
+/**
+ * @brief Every layer transparent and nothing composited yet, as after power on - a fresh simulated device (stress runs)
+ * Render targets are given back by their owner (LumaFSM), the persistence set by the tunables is kept
+ *
+ */
+void Compositor_Reset() {
+    memset(layers, 0, sizeof(layers));
+    dirtyMask = 0xFFFF;
+    lastMask = 0;
+}
+
+// ==================== Compositor ====================
+/**
+ * @brief Blends every layer of the mask for one pixel, bottom to top
+ *
+ */
+static inline Rgb16 compositePixel(uint16_t layerMask, int i) {
+    Rgb16 out = RGB16_BLACK;
+
+    for (int id = 0; id < LAYER_COUNT; id++) {
+        if (!(layerMask & LAYER_BIT(id))) continue;
+
+        Rgb16 c = (id == LAYER_PALETTE) ? Palette_GetColor(i) : PIXELS(id)[i];
+        if (Color_IsBlack(c)) continue;     // transparent
+
+        out = blend(out, c, config[id]);
+    }
+    return out;
+}
+
+/**
+ * @brief Blends the selected layers and shows the frame through the output stage
+ *
+ * Single pass over the pixels, every layer of the mask is blended bottom to top and the result
+ * is encoded for the LEDs once. Nothing new is sent to the LEDs if none of the layers changed,
+ * only the dither refresh of the frame already shown
+ *
+ * @param layerMask LAYER_BIT() of every layer that takes part
+ * @return uint16_t LAYER_BIT() of the layers that are new on the LEDs (redrawn since the last composite, all of them
+ * if the layer set changed, the palette layer always), 0 if no new frame was sent
+ */
+uint16_t Compositor_Present(uint16_t layerMask) {
+    TRACE_SPAN("Compositor_Present");
+    bool usesPalette = layerMask & LAYER_BIT(LAYER_PALETTE);   // palette frame has no dirty tracking -> always recomposite
+
+    if (layerMask == lastMask && !(layerMask & dirtyMask) && !usesPalette) {
+        Output_Refresh();       // unchanged frame, but the dither may still be averaging sub-LSB levels
+        return 0;
+    }
+
+    uint16_t shown = (layerMask == lastMask) ? (layerMask & (dirtyMask | LAYER_BIT(LAYER_PALETTE))) : layerMask;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        outFrame[i] = compositePixel(layerMask, i);
+    }
+    Output_Show(outFrame);
+
+    dirtyMask &= ~layerMask;
+    lastMask = layerMask;
+    return shown;
+}
+
+/**
+ * @brief Same composite pass as Compositor_Present but into an offscreen frame
+ * Nothing is shown and the dirty state of the matrix is left alone
+ *
+ * @param layerMask LAYER_BIT() of every layer that takes part
+ * @param target Frame that receives the result
+ */
+void Compositor_Resolve(uint16_t layerMask, RenderTarget &target) {
+    for (int i = 0; i < NUM_LEDS; i++) {
+        target.pixels[i] = compositePixel(layerMask, i);
+    }
+}
+
+static inline Rgb16 lerpPixel(const Rgb16 &a, const Rgb16 &b, uint8_t amount) {
+    Rgb16 out;
+    out.r = a.r + (((int32_t)(b.r - a.r) * amount) >> 8);
+    out.g = a.g + (((int32_t)(b.g - a.g) * amount) >> 8);
+    out.b = a.b + (((int32_t)(b.b - a.b) * amount) >> 8);
+    return out;
+}
+
+/**
+ * @brief Crossfades two offscreen frames and shows the result through the output stage
+ *
+ * Fixed point kernel - per channel from + (to - from) * amount / 256 in linear light, so the mix
+ * has no brightness dip halfway. The matrix no longer matches any layer set afterwards, so the
+ * next Compositor_Present always recomposites
+ *
+ * @param from Frame at amount 0
+ * @param to Frame at amount 255
+ * @param amount Blend position 0-255
+ */
+void Compositor_PresentBlend(const RenderTarget &from, const RenderTarget &to, uint8_t amount) {
+    for (int i = 0; i < NUM_LEDS; i++) {
+        outFrame[i] = lerpPixel(from.pixels[i], to.pixels[i], amount);
+    }
+    Output_Show(outFrame);
+
+    lastMask = 0;
+}
+
+/**
+ * @brief Same crossfade kernel but written back into from, nothing is shown
+ * A transition that interrupts a running crossfade starts from the blend on the LEDs, not from either frame
+ *
+ * @param from Frame at amount 0, receives the result
+ * @param to Frame at amount 255
+ * @param amount Blend position 0-255
+ */
+void Compositor_ResolveBlend(RenderTarget &from, const RenderTarget &to, uint8_t amount) {
+    for (int i = 0; i < NUM_LEDS; i++) {
+        from.pixels[i] = lerpPixel(from.pixels[i], to.pixels[i], amount);
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file console.cpp
+ * @author sarvesh
+ * @brief Implementation of console.h
+ * @version 1.0
+ * @date 2026-2-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "console.h"
+#include "memstats.h"
+#include "latency.h"
+#include "profiles.h"
+#include "vm.h"
+#include "snapshot.h"
+#include "clock.h"
+#include "tune.h"
+#include "output.h"
+#include "trace.h"
+
+static void Console_Help(const char *args);
+
+// ==================== Command Table ====================
+static const ConsoleCommand COMMANDS[] = {
+    { "help", Console_Help,   "list commands" },
+    { "mem",  MemStats_Print, "static, heap and stack usage" },
+    { "lat",  Latency_Print,  "input to photon latency per state ('lat reset' clears)" },
+    { "clock", Clock_Command, "state clock status | pause, resume | scale <percent>" },
+    { "snap", Snapshot_Command, "stored state snapshot | fast on, fast off | clear" },
+    { "power", Output_PowerCommand, "LED current estimate and limiter activity | reset" },
+    { "set",  Tune_Command,   "list tunables | <name> <value> | save | defaults" },
+#ifdef LUMA_TRACE
+    { "trace", Trace_Command, "dump the span ring as Chrome trace JSON | clear" },
+#endif
+#if LUMA_FEATURE_SCRIPT
+    { "vm",   Vm_Command,     "script program status | begin, put <offset> <hex>, end | reset" },
+#endif
+};
+
+#define COMMAND_COUNT (sizeof(COMMANDS) / sizeof(COMMANDS[0]))
+
+static char line[CONSOLE_LINE_MAX];     // line being typed
+static uint8_t lineLength = 0;          // characters in line
+static bool overflow = false;           // current line is too long -> drop it at the newline
+
+static_assert(sizeof(line) + sizeof(lineLength) + sizeof(overflow) <= MEM_BUDGET_CONSOLE, "console statics exceed MEM_BUDGET_CONSOLE");
+
+/**
+ * @brief Prints every command with its description
+ *
+ */
+static void Console_Help(const char *args) {
+    (void)args;
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        Serial.print(COMMANDS[i].name);
+        Serial.print(" - ");
+        Serial.println(COMMANDS[i].help);
+    }
+}
+
+/**
+ * @brief Splits a complete line into command and arguments and runs it
+ *
+ */
+static void Console_Run(char *text) {
+    char *args = strchr(text, ' ');     // command name ends at the first space
+    if (args) {
+        *args++ = '\0';
+        while (*args == ' ') args++;
+    } else {
+        args = text + strlen(text);     // no arguments -> empty string
+    }
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        if (strcmp(text, COMMANDS[i].name) == 0) {
+            COMMANDS[i].handler(args);
+            return;
+        }
+    }
+    Serial.print("unknown command: ");
+    Serial.println(text);
+}
+
+/**
+ * @brief Consumes pending Serial input and runs a command for every complete line
+ * Only reads what has already arrived, so it never waits for the user
+ */
+void Console_Poll() {
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+
+        if (c == '\r' || c == '\n') {       // end of line -> CR, LF or CRLF all work, empty lines are ignored
+            if (lineLength && !overflow) {
+                line[lineLength] = '\0';
+                Console_Run(line);
+            }
+            lineLength = 0;
+            overflow = false;
+        } else if (lineLength < CONSOLE_LINE_MAX - 1) {
+            line[lineLength++] = c;
+        } else {
+            overflow = true;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file easing.cpp
+ * @author sarvesh
+ * @brief Implementation of easing.h
+ * @version 1.0
+ * @date 2026-2-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "easing.h"
+
+// Generated offline with integer math : t -> curve(t / 255) * 255, so every entry is exact and nothing is computed at boot
+const uint8_t EASE_LUT[3][256] = {
+    // EASE_IN - quadratic t^2, starts slow
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+          1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   3,   3,   3,   3,
+          4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,   7,   7,   7,   8,   8,
+          9,   9,   9,  10,  10,  11,  11,  11,  12,  12,  13,  13,  14,  14,  15,  15,
+         16,  16,  17,  17,  18,  18,  19,  19,  20,  20,  21,  22,  22,  23,  23,  24,
+         25,  25,  26,  27,  27,  28,  29,  29,  30,  31,  31,  32,  33,  33,  34,  35,
+         36,  36,  37,  38,  39,  40,  40,  41,  42,  43,  44,  44,  45,  46,  47,  48,
+         49,  50,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+         64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  79,  80,
+         81,  82,  83,  84,  85,  87,  88,  89,  90,  91,  93,  94,  95,  96,  97,  99,
+        100, 101, 102, 104, 105, 106, 108, 109, 110, 112, 113, 114, 116, 117, 118, 120,
+        121, 122, 124, 125, 127, 128, 129, 131, 132, 134, 135, 137, 138, 140, 141, 143,
+        144, 146, 147, 149, 150, 152, 153, 155, 156, 158, 160, 161, 163, 164, 166, 168,
+        169, 171, 172, 174, 176, 177, 179, 181, 182, 184, 186, 188, 189, 191, 193, 195,
+        196, 198, 200, 202, 203, 205, 207, 209, 211, 212, 214, 216, 218, 220, 222, 224,
+        225, 227, 229, 231, 233, 235, 237, 239, 241, 243, 245, 247, 249, 251, 253, 255,
+    },
+    // EASE_OUT - quadratic 1-(1-t)^2, ends slow
+    {
+          0,   2,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,
+         31,  33,  35,  37,  39,  41,  43,  44,  46,  48,  50,  52,  53,  55,  57,  59,
+         60,  62,  64,  66,  67,  69,  71,  73,  74,  76,  78,  79,  81,  83,  84,  86,
+         87,  89,  91,  92,  94,  95,  97,  99, 100, 102, 103, 105, 106, 108, 109, 111,
+        112, 114, 115, 117, 118, 120, 121, 123, 124, 126, 127, 128, 130, 131, 133, 134,
+        135, 137, 138, 139, 141, 142, 143, 145, 146, 147, 149, 150, 151, 153, 154, 155,
+        156, 158, 159, 160, 161, 162, 164, 165, 166, 167, 168, 170, 171, 172, 173, 174,
+        175, 176, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+        192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 205, 206,
+        207, 208, 209, 210, 211, 211, 212, 213, 214, 215, 215, 216, 217, 218, 219, 219,
+        220, 221, 222, 222, 223, 224, 224, 225, 226, 226, 227, 228, 228, 229, 230, 230,
+        231, 232, 232, 233, 233, 234, 235, 235, 236, 236, 237, 237, 238, 238, 239, 239,
+        240, 240, 241, 241, 242, 242, 243, 243, 244, 244, 244, 245, 245, 246, 246, 246,
+        247, 247, 248, 248, 248, 249, 249, 249, 250, 250, 250, 250, 251, 251, 251, 251,
+        252, 252, 252, 252, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    },
+    // EASE_IN_OUT - smoothstep 3t^2-2t^3
+    {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   2,   2,
+          2,   3,   3,   4,   4,   4,   5,   5,   6,   6,   7,   7,   8,   9,   9,  10,
+         11,  11,  12,  13,  13,  14,  15,  16,  16,  17,  18,  19,  20,  21,  21,  22,
+         23,  24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  39,
+         40,  41,  42,  43,  44,  45,  47,  48,  49,  50,  51,  53,  54,  55,  56,  58,
+         59,  60,  62,  63,  64,  66,  67,  68,  70,  71,  72,  74,  75,  77,  78,  79,
+         81,  82,  84,  85,  86,  88,  89,  91,  92,  94,  95,  97,  98,  99, 101, 102,
+        104, 105, 107, 108, 110, 111, 113, 114, 116, 117, 119, 120, 122, 123, 125, 126,
+        128, 129, 131, 132, 134, 135, 137, 138, 140, 141, 143, 144, 146, 147, 149, 150,
+        152, 153, 155, 156, 157, 159, 160, 162, 163, 165, 166, 168, 169, 170, 172, 173,
+        175, 176, 177, 179, 180, 182, 183, 184, 186, 187, 188, 190, 191, 192, 194, 195,
+        196, 198, 199, 200, 201, 203, 204, 205, 206, 207, 209, 210, 211, 212, 213, 214,
+        215, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231,
+        232, 233, 233, 234, 235, 236, 237, 238, 238, 239, 240, 241, 241, 242, 243, 243,
+        244, 245, 245, 246, 247, 247, 248, 248, 249, 249, 250, 250, 250, 251, 251, 252,
+        252, 252, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255,
+    }
+};
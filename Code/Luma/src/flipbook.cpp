@@ -0,0 +1,202 @@
+/**
+ * @file flipbook.cpp
+ * @author sarvesh
+ * @brief Implementation of flipbook.h
+ * @version 1.0
+ * @date 2026-2-26
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "flipbook.h"
+#include "ws2812b.h"
+#include "palette.h"
+#include "color.h"
+#include "memstats.h"
+#include "trace.h"
+
+#include "esp_partition.h"
+
+static const uint8_t *image = nullptr;  // start of the mapped window, nullptr -> no flipbook
+static uint32_t imageLength = 0;
+
+static_assert(sizeof(image) + sizeof(imageLength) <= MEM_BUDGET_FLIPBOOK, "flipbook state exceeds MEM_BUDGET_FLIPBOOK");
+
+// ==================== Helpers ====================
+static inline uint16_t read16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t read32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief true if the directory at the start of an image is valid and fits in length bytes
+ *
+ */
+static bool directoryValid(const uint8_t *data, uint32_t length) {
+    if (length < FLIPBOOK_DIR_SIZE) return false;
+    if (data[0] != 'L' || data[1] != 'F' || data[2] != 'B' || data[3] != '1') return false;
+    return (uint32_t)FLIPBOOK_DIR_SIZE + data[8] * FLIPBOOK_ENTRY_SIZE <= length;
+}
+
+// ==================== Mount ====================
+/**
+ * @brief Maps the flipbook into the address space
+ * On the ESP32 only the directory is read through the flash driver, then exactly the image length
+ * is mapped through the MMU as data - playback reads flash through the cache like const data
+ *
+ * @return true if a valid flipbook image is mapped
+ */
+bool Flipbook_Mount() {
+    if (image) return true;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                (esp_partition_subtype_t)FLIPBOOK_SUBTYPE, FLIPBOOK_PARTITION);
+    if (!partition) return false;
+
+    uint8_t directory[FLIPBOOK_DIR_SIZE];
+    if (esp_partition_read(partition, 0, directory, sizeof(directory)) != ESP_OK) return false;
+
+    uint32_t length = read32(directory + 4);
+    if (length < FLIPBOOK_DIR_SIZE || length > partition->size) return false;  // erased flash reads 0xFFFFFFFF
+
+    const void *mapped;
+    spi_flash_mmap_handle_t handle;     // mapped for the lifetime of the firmware, never unmapped
+    if (esp_partition_mmap(partition, 0, length, SPI_FLASH_MMAP_DATA, &mapped, &handle) != ESP_OK) return false;
+
+    if (!directoryValid((const uint8_t *)mapped, length)) return false;
+
+    image = (const uint8_t *)mapped;
+    imageLength = length;
+    return true;
+}
+
+// ==================== Playback ====================
+/**
+ * @brief Byte size of one frame, 0 if it is malformed or runs past end
+ *
+ */
+static uint16_t frameSize(const uint8_t *frame, const uint8_t *end) {
+    if (end - frame < 2) return 0;
+
+    switch (frame[0]) {
+        case FLIP_KEY:
+            return (end - frame >= 2 + NUM_LEDS) ? 2 + NUM_LEDS : 0;
+
+        case FLIP_DELTA: {
+            if (end - frame < 3) return 0;
+            uint16_t size = 3 + frame[2] * 2;
+            if (end - frame < size) return 0;
+            for (uint8_t i = 0; i < frame[2]; i++) {
+                if (frame[3 + i * 2] >= NUM_LEDS) return 0;     // pixel outside the matrix
+            }
+            return size;
+        }
+
+        case FLIP_LEVEL:
+            return (end - frame >= 3) ? 3 : 0;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Finds a sequence, checks every frame once and loads its palette
+ * After this the player decodes without any bounds checks, like a verified VM program
+ *
+ * @param player Player to start
+ * @param name Sequence name from the directory
+ * @param now Current time in ms
+ * @return true if the sequence exists, fits the matrix and is well formed
+ */
+bool Flipbook_Open(FlipbookPlayer &player, const char *name, unsigned long now) {
+    player.sequence = nullptr;
+    player.running = false;
+    if (!image) return false;
+
+    uint8_t count = image[8];
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *entry = image + FLIPBOOK_DIR_SIZE + i * FLIPBOOK_ENTRY_SIZE;
+        if (strncmp((const char *)entry, name, FLIPBOOK_NAME_MAX) != 0) continue;
+
+        uint32_t offset = read32(entry + 8);
+        uint32_t length = read32(entry + 12);
+        if (offset > imageLength || length > imageLength - offset || length < FLIPBOOK_SEQ_SIZE) return false;
+
+        const uint8_t *sequence = image + offset;
+        const uint8_t *end = sequence + length;
+        uint16_t paletteSize = read16(sequence + 4);
+        if (sequence[6] != WIDTH || sequence[7] != HEIGHT) return false;
+        if (paletteSize > PALETTE_SIZE || FLIPBOOK_SEQ_SIZE + paletteSize * 3u > length) return false;
+
+        const uint8_t *frames = sequence + FLIPBOOK_SEQ_SIZE + paletteSize * 3;
+        const uint8_t *frame = frames;
+        for (uint16_t f = 0; f < read16(sequence); f++) {
+            uint16_t size = frameSize(frame, end);
+            if (!size) return false;
+            frame += size;
+        }
+
+        Palette_Acquire(PALETTE_OWNER_FLIPBOOK);
+        Palette_SetLevel(255);
+        Palette_SetRotation(0);
+        const uint8_t *rgb = sequence + FLIPBOOK_SEQ_SIZE;
+        for (int p = 0; p < PALETTE_SIZE; p++) {    // entries the sequence does not define are black
+            Palette_Set(p, p < paletteSize ? Color_Hex(((uint32_t)rgb[p * 3] << 16) | (rgb[p * 3 + 1] << 8) | rgb[p * 3 + 2])
+                                           : RGB16_BLACK);
+        }
+        Palette_Clear();
+
+        player.sequence = sequence;
+        player.cursor = frames;
+        player.frame = 0;
+        player.frameCount = read16(sequence);
+        player.frameMs = read16(sequence + 2);
+        player.nextAt = now;
+        player.running = player.frameCount > 0;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Applies every frame that is due to the palette framebuffer
+ * A late call catches up frame by frame, so deltas are never skipped
+ *
+ * @return true until the hold time of the last frame is over
+ */
+bool Flipbook_Update(FlipbookPlayer &player, unsigned long now) {
+    TRACE_SPAN("Flipbook_Update");
+    while (player.running && (long)(now - player.nextAt) >= 0) {
+        if (player.frame >= player.frameCount) {    // last frame held long enough
+            player.running = false;
+            break;
+        }
+        const uint8_t *frame = player.cursor;
+
+        switch (frame[0]) {
+            case FLIP_KEY:
+                for (int i = 0; i < NUM_LEDS; i++) Palette_SetPixel(i, frame[2 + i]);
+                player.cursor += 2 + NUM_LEDS;
+                break;
+
+            case FLIP_DELTA:
+                for (uint8_t i = 0; i < frame[2]; i++) Palette_SetPixel(frame[3 + i * 2], frame[4 + i * 2]);
+                player.cursor += 3 + frame[2] * 2;
+                break;
+
+            case FLIP_LEVEL:
+                Palette_SetLevel(frame[2]);
+                player.cursor += 3;
+                break;
+        }
+
+        player.nextAt += frame[1] ? frame[1] * FLIPBOOK_HOLD_MS : player.frameMs;
+        player.frame++;
+    }
+    return player.running;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file font.cpp
+ * @author sarvesh
+ * @brief Implementation of font.h
+ * @version 1.0
+ * @date 2026-2-12
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "font.h"
+#include "ws2812b.h"
+#include "clock.h"
+#include "trace.h"
+
+// ==================== Font Data ====================
+#define FONT_FIRST ' '      // first glyph in the table
+#define FONT_LAST  'Z'      // last glyph in the table, lower case is drawn as upper case
+
+// 3 column bitmasks per glyph (bit 0 = top row) - const so it stays in flash, 177 bytes for the whole font
+static const uint8_t FONT[FONT_LAST - FONT_FIRST + 1][FONT_WIDTH] = {
+    { 0x00, 0x00, 0x00 },   // ' '
+    { 0x00, 0x17, 0x00 },   // '!'
+    { 0x00, 0x00, 0x00 },   // '"'
+    { 0x00, 0x00, 0x00 },   // '#'
+    { 0x00, 0x00, 0x00 },   // '$'
+    { 0x09, 0x04, 0x12 },   // '%'
+    { 0x00, 0x00, 0x00 },   // '&'
+    { 0x00, 0x00, 0x00 },   // "'"
+    { 0x00, 0x00, 0x00 },   // '('
+    { 0x00, 0x00, 0x00 },   // ')'
+    { 0x00, 0x00, 0x00 },   // '*'
+    { 0x04, 0x0E, 0x04 },   // '+'
+    { 0x00, 0x00, 0x00 },   // ','
+    { 0x04, 0x04, 0x04 },   // '-'
+    { 0x00, 0x10, 0x00 },   // '.'
+    { 0x18, 0x04, 0x03 },   // '/'
+    { 0x1F, 0x11, 0x1F },   // '0'
+    { 0x12, 0x1F, 0x10 },   // '1'
+    { 0x19, 0x15, 0x12 },   // '2'
+    { 0x11, 0x15, 0x0A },   // '3'
+    { 0x07, 0x04, 0x1F },   // '4'
+    { 0x17, 0x15, 0x09 },   // '5'
+    { 0x1E, 0x15, 0x1D },   // '6'
+    { 0x01, 0x1D, 0x03 },   // '7'
+    { 0x1F, 0x15, 0x1F },   // '8'
+    { 0x17, 0x15, 0x0F },   // '9'
+    { 0x00, 0x0A, 0x00 },   // ':'
+    { 0x00, 0x00, 0x00 },   // ';'
+    { 0x00, 0x00, 0x00 },   // '<'
+    { 0x0A, 0x0A, 0x0A },   // '='
+    { 0x00, 0x00, 0x00 },   // '>'
+    { 0x00, 0x00, 0x00 },   // '?'
+    { 0x00, 0x00, 0x00 },   // '@'
+    { 0x1E, 0x05, 0x1E },   // 'A'
+    { 0x1F, 0x15, 0x0A },   // 'B'
+    { 0x0E, 0x11, 0x11 },   // 'C'
+    { 0x1F, 0x11, 0x0E },   // 'D'
+    { 0x1F, 0x15, 0x11 },   // 'E'
+    { 0x1F, 0x05, 0x01 },   // 'F'
+    { 0x0E, 0x11, 0x1D },   // 'G'
+    { 0x1F, 0x04, 0x1F },   // 'H'
+    { 0x11, 0x1F, 0x11 },   // 'I'
+    { 0x08, 0x10, 0x0F },   // 'J'
+    { 0x1F, 0x04, 0x1B },   // 'K'
+    { 0x1F, 0x10, 0x10 },   // 'L'
+    { 0x1F, 0x06, 0x1F },   // 'M'
+    { 0x1F, 0x01, 0x1E },   // 'N'
+    { 0x0E, 0x11, 0x0E },   // 'O'
+    { 0x1F, 0x05, 0x02 },   // 'P'
+    { 0x0E, 0x19, 0x16 },   // 'Q'
+    { 0x1F, 0x05, 0x1A },   // 'R'
+    { 0x12, 0x15, 0x09 },   // 'S'
+    { 0x01, 0x1F, 0x01 },   // 'T'
+    { 0x1F, 0x10, 0x1F },   // 'U'
+    { 0x0F, 0x10, 0x0F },   // 'V'
+    { 0x1F, 0x0C, 0x1F },   // 'W'
+    { 0x1B, 0x04, 0x1B },   // 'X'
+    { 0x03, 0x1C, 0x03 },   // 'Y'
+    { 0x19, 0x15, 0x13 },   // 'Z'
+};
+
+// ==================== Text ====================
+/**
+ * @brief Bitmask of one column of a string
+ * Column col belongs to character col / FONT_ADVANCE, so any column is found without walking the string
+ *
+ * @param text String to draw
+ * @param length strlen of text
+ * @param col Column in the rendered string, may be negative or past the end
+ * @return uint8_t Column bits, bit 0 is the top row
+ */
+uint8_t Font_Column(const char *text, uint8_t length, int col) {
+    if (col < 0) return 0;
+
+    int ch = col / FONT_ADVANCE;
+    int glyphCol = col % FONT_ADVANCE;
+    if (ch >= length || glyphCol >= FONT_WIDTH) return 0;   // past the end or the spacing column
+
+    char c = text[ch];
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if (c < FONT_FIRST || c > FONT_LAST) return 0;          // no glyph -> blank
+
+    return FONT[c - FONT_FIRST][glyphCol];
+}
+
+/**
+ * @brief Draws the visible part of a string into a layer
+ * Cost is WIDTH columns x FONT_HEIGHT bits whatever the string length
+ *
+ * @param layer Layer to draw into (only the lit pixels are written)
+ * @param text String to draw
+ * @param scrollCol String column shown in matrix column 0
+ * @param topRow Matrix row of the top of the glyphs
+ * @param color Text color
+ */
+void Text_Draw(LayerId layer, const char *text, int scrollCol, int topRow, const Rgb16 &color) {
+    uint8_t length = strlen(text);
+
+    for (int x = 0; x < WIDTH; x++) {
+        uint8_t bits = Font_Column(text, length, scrollCol + x);
+
+        for (int r = 0; bits; r++, bits >>= 1) {       // shift the column out bit by bit, stops at the last lit row
+            int y = topRow + r;
+            if ((bits & 1) && y >= 0 && y < HEIGHT) {
+                Layer_SetPixel(layer, pixelIndex(y, x), color);
+            }
+        }
+    }
+}
+
+// ==================== Scrolling Text ====================
+/**
+ * @brief Starts scrolling a string, it enters from the right edge of the matrix
+ *
+ * @param scroller Scroller state
+ * @param text String to scroll, must stay valid while scrolling
+ * @param stepMs Time per column | smaller -> faster
+ */
+void Scroller_Start(TextScroller &scroller, const char *text, uint16_t stepMs) {
+    scroller.text = text;
+    scroller.length = strlen(text);
+    scroller.offset = -WIDTH;       // first column starts just outside the right edge
+    scroller.stepMs = stepMs;
+    scroller.lastStep = Clock_Now();
+    scroller.active = true;
+}
+
+/**
+ * @brief Moves the scroller one column when a step is due
+ *
+ * @return true if the visible columns changed and the label has to be redrawn
+ */
+bool Scroller_Update(TextScroller &scroller) {
+    TRACE_SPAN("Scroller_Update");
+    if (!scroller.active) return false;
+    if (Clock_Now() - scroller.lastStep < scroller.stepMs) return false;
+
+    scroller.lastStep = Clock_Now();
+    scroller.offset++;
+
+    if (scroller.offset >= scroller.length * FONT_ADVANCE) {   // last column left the matrix
+        scroller.active = false;
+    }
+    return true;
+}
+
+/**
+ * @brief Draws the visible columns of the scroller
+ *
+ */
+void Scroller_Draw(const TextScroller &scroller, LayerId layer, int topRow, const Rgb16 &color) {
+    if (!scroller.active) return;
+    Text_Draw(layer, scroller.text, scroller.offset, topRow, color);
+}
@@ -12,34 +12,83 @@
 #include "fsm.h"
 #include "ws2812b.h"
 #include "animations.h"
-
-// === Screensaver global variables (The FSM and Button Handler both need this) ===
-static SaverPhase phase = MOVE;
-static unsigned long phaseStart = 0;
+#include "palette.h"
+#include "compositor.h"
+#include "timeline.h"
+#include "font.h"
+#include "color.h"
+#include "memstats.h"
+#include "latency.h"
+#include "vm.h"
+#include "flipbook.h"
+#include "snapshot.h"
+#include "clock.h"
+#include "tune.h"
+#include "trace.h"
+
+// Menu label - scrolls once over the preview whenever the menu is entered or cycled
+#define LABEL_COLOR   Color_Hex(0x676767)       // dim white, readable over the previews
 
 // Menu Label Strings
 const char* menuNames[MENU_COUNT] = {
+#if LUMA_FEATURE_COLOR_FLOOD
     "COLOR FLOOD",
-    "FALLING PIXELS"
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    "FALLING PIXELS",
+#endif
+#if LUMA_FEATURE_AURORA
+    "AURORA",
+#endif
+#if LUMA_FEATURE_SCRIPT
+    "SCRIPT",
+#endif
 };
 
 // ==================== Constructor [Initializng Valid States] ====================
 LumaFSM::LumaFSM()
     : currentState(STATE_DEVICE_ON),    // starts in boot animation
       previousState(STATE_DEVICE_ON),   // same as current state so no false transition
-      stateStartTime(millis()),         // starts state timer
+      selectedMenuOption(MenuOption(0)),    // first entry of the menu
+      stateStartTime(0),                // starts state timer (every clock starts at 0)
       timerStartTime(0),
-      totalTimerDuration(0) {
-        Serial.println("[FSM] LUMA Initialized - Starting STATE_DEVICE_ON");
+      totalTimerDuration(0),
+      bootPlayer(),
+      bootFlip(),
+      offCount(0),
+      phase(MOVE),
+      menuLabel(),
+      backgroundPreview(0),
+      colorFloodInit(false),
+      fallingPixelInit(false),
+      auroraInit(false),
+      scriptInit(false),
+      fadeFrom(nullptr),
+      fadeTo(nullptr),
+      fadeFrame(0),
+      inputEvent(0) {
+        Effects_Init(effects);
+        LOG("[FSM] LUMA Initialized - Starting STATE_DEVICE_ON");
+}
+
+/**
+ * @brief Gives the offscreen frames of a crossfade in progress back to the pool
+ * Simulated devices come and go (stress runs), a device destroyed mid-transition must not keep them
+ *
+ */
+LumaFSM::~LumaFSM() {
+    RenderTarget_Release(fadeFrom);
+    RenderTarget_Release(fadeTo);
 }
 
 // ==================== Main Update Loop ====================
 // First public function - Called every 20ms -> 1000ms / 20ms = 50FPS
 void LumaFSM::update() {
+    TRACE_SPAN("LumaFSM::update");
     // Check if state has changed (for transition logging)
     if (currentState != previousState) {
         logStateTransition(previousState, currentState);
-        stateStartTime = millis();
+        stateStartTime = Clock_Now();   // the new state's own clock, selected in transitionTo
         previousState = currentState;
     }
 
@@ -54,131 +103,338 @@ void LumaFSM::update() {
         case STATE_DEVICE_MENU:
             handleState_DeviceMenu();
             break;
+#if LUMA_FEATURE_COLOR_FLOOD
         case STATE_COLOR_FLOOD:
             handleState_ColorFlood();
             break;
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
         case STATE_FALLING_PIXEL:
             handleState_FallingPixel();
             break;
+#endif
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:
+            handleState_Aurora();
+            break;
+#endif
+#if LUMA_FEATURE_SCRIPT
+        case STATE_SCRIPT:
+            handleState_Script();
+            break;
+#endif
         default:
-            Serial.println("[FSM] ERROR: Unknown state!");
+            LOG("[FSM] ERROR: Unknown state!");
             break;
     }
+
+    presentFrame();     // Single composite pass - the layers the state handler drew into go to the matrix once per frame
+
+#ifndef LUMA_STRESS
+    if (Snapshot_Due(Clock_Uptime())) offerSnapshot();    // once per second, the writer decides if it goes to flash
+#endif  // stress runs must not overwrite the stored snapshot
 }
 
 // ==================== Button Inputs ====================
 // Button A : All state transistions are mentioned below
-void LumaFSM::onButtonAPressed(bool longPress) {
-    Serial.print("[BTN] Button A ");
-    Serial.println(longPress ? "LONG PRESS" : "SHORT PRESS");
+void LumaFSM::onButtonAPressed(bool longPress, uint16_t eventId) {
+    if (eventId) inputEvent = eventId;  // the next shown frame carries the result of this press
+    LOG_PART("[BTN] Button A ");
+    LOG(longPress ? "LONG PRESS" : "SHORT PRESS");
     
     // Button A behavior varies by state
     switch (currentState) {
 
         case STATE_DEVICE_SCREENSAVER:
             if (!longPress) {   // Short press
-                Serial.println("[ACTION] Screensaver -> Menu (Button A short)");
+                LOG("[ACTION] Screensaver -> Menu (Button A short)");
                 transitionTo(STATE_DEVICE_MENU);
             }
             else {              // Long press
-                Serial.println("[BTN] Button A long press ignored in this state");
+                LOG("[BTN] Button A long press ignored in this state");
             }
             break;
 
         case STATE_DEVICE_MENU:  
             if (!longPress) {   // Short press   
-                Serial.println("[ACTION] Screensaver <- Menu (Button A short)");
+                LOG("[ACTION] Screensaver <- Menu (Button A short)");
                 transitionTo(STATE_DEVICE_SCREENSAVER);
             }
             else {              // Long press
-                Serial.println("[BTN] Button A long press ignored in this state");
+                LOG("[BTN] Button A long press ignored in this state");
             }
             break;   
+#if LUMA_FEATURE_COLOR_FLOOD
         case STATE_COLOR_FLOOD:
             if (!longPress) {   // Short press
-                Serial.println("[ACTION] Menu <- Color Flood (Button A short)");
+                LOG("[ACTION] Menu <- Color Flood (Button A short)");
                 transitionTo(STATE_DEVICE_MENU);
             }
             else                // Long press
-                Serial.println("[BTN] Button A long press ignored in this state");
+                LOG("[BTN] Button A long press ignored in this state");
             break;
+#endif
 
+#if LUMA_FEATURE_FALLING_PIXEL
         case STATE_FALLING_PIXEL:
             if(!longPress) {    // Short press
-                Serial.println("[BTN] Button A short press ignored in this state");
+                LOG("[BTN] Button A short press ignored in this state");
+            }
+            else {              // Long press
+                LOG("[ACTION] Menu <- Falling Pixel (Button A long)");
+                transitionTo(STATE_DEVICE_MENU);
+            }
+            break;
+#endif
+
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:
+            if (!longPress) {   // Short press
+                LOG("[ACTION] Menu <- Aurora (Button A short)");
+                transitionTo(STATE_DEVICE_MENU);
             }
             else                // Long press
-                Serial.println("[ACTION] Menu <- Falling Pixel (Button A long)");
+                LOG("[BTN] Button A long press ignored in this state");
+            break;
+#endif
+
+#if LUMA_FEATURE_SCRIPT
+        case STATE_SCRIPT:
+            if (!longPress) {   // Short press
+                LOG("[ACTION] Menu <- Script (Button A short)");
                 transitionTo(STATE_DEVICE_MENU);
+            }
+            else                // Long press -> the program decides
+                Vm_Button(VM_BUTTON_A_HOLD);
+            break;
+#endif
+
         default:
-            Serial.println("[BTN] Button A ignored in this state");
+            LOG("[BTN] Button A ignored in this state");
             break;
     }
 }
 
 // Button B : All state transistions are mentioned here
-void LumaFSM::onButtonBPressed(bool longPress) {
-    Serial.print("[BTN] Button B ");
-    Serial.println(longPress ? "LONG PRESS" : "SHORT PRESS");
+void LumaFSM::onButtonBPressed(bool longPress, uint16_t eventId) {
+    if (eventId) inputEvent = eventId;  // the next shown frame carries the result of this press
+    LOG_PART("[BTN] Button B ");
+    LOG(longPress ? "LONG PRESS" : "SHORT PRESS");
     
     // Button B behavior varies by state
     switch (currentState) {
 
         case STATE_DEVICE_SCREENSAVER:  
             if (!longPress) {   // Short press
-                Serial.println("[ACTION] Orb hit it will explode");
-                phaseStart = millis();
-                phase = VIBRATE;
+                LOG("[ACTION] Orb hit it will explode");
+                startOrbHit(effects.hit, effects.orb, effects.view);  // vibrate then explode where the orb is - see HIT_TIMELINE
+                phase = HIT;
             }
             else {              // Long press
-                Serial.println("[BTN] Button B long press ignored in this state");
+                LOG("[BTN] Button B long press ignored in this state");
             }
             break;
 
         case STATE_DEVICE_MENU:
             if (!longPress) {   // Short Press B to Cycle menu option
                 selectedMenuOption = (MenuOption)((selectedMenuOption + 1) % MENU_COUNT);
-                Serial.print("[ACTION] Menu cycled -> ");
-                Serial.println(menuNames[selectedMenuOption]);
+                Scroller_Start(menuLabel, menuNames[selectedMenuOption], TUNE(label_ms));
+                LOG_PART("[ACTION] Menu cycled -> ");
+                LOG(menuNames[selectedMenuOption]);
             } 
             else {              // Long press B to select the menu option
-                if (selectedMenuOption == MENU_COLOR_FLOOD) {
-                    Serial.println("[ACTION] Menu selected Color Flood");
-                    transitionTo(STATE_COLOR_FLOOD);
-                } else if (selectedMenuOption == MENU_FALLING_PIXELS) {
-                    Serial.println("[ACTION] Menu selected Falling Pixels");
-                    transitionTo(STATE_FALLING_PIXEL);
+                switch (selectedMenuOption) {
+#if LUMA_FEATURE_COLOR_FLOOD
+                    case MENU_COLOR_FLOOD:
+                        LOG("[ACTION] Menu selected Color Flood");
+                        transitionTo(STATE_COLOR_FLOOD);
+                        break;
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+                    case MENU_FALLING_PIXELS:
+                        LOG("[ACTION] Menu selected Falling Pixels");
+                        transitionTo(STATE_FALLING_PIXEL);
+                        break;
+#endif
+#if LUMA_FEATURE_AURORA
+                    case MENU_AURORA:
+                        LOG("[ACTION] Menu selected Aurora");
+                        transitionTo(STATE_AURORA);
+                        break;
+#endif
+#if LUMA_FEATURE_SCRIPT
+                    case MENU_SCRIPT:
+                        LOG("[ACTION] Menu selected Script");
+                        transitionTo(STATE_SCRIPT);
+                        break;
+#endif
+                    default:
+                        break;
                 }
             }
             break;   
+#if LUMA_FEATURE_COLOR_FLOOD
         case STATE_COLOR_FLOOD:
             if (!longPress) {   // Short press
-                ColorFlood_StartNew();   // inject new color
-                Serial.println("[ACTION] New Color Flood Injected");
+                ColorFlood_StartNew(effects.flood);  // inject new color
+                LOG("[ACTION] New Color Flood Injected");
             } 
             else {              // long press
-                Serial.println("[BTN] Button B long press ignored in this state");
+                LOG("[BTN] Button B long press ignored in this state");
             }
             break;
-            
+#endif
+
+#if LUMA_FEATURE_FALLING_PIXEL
         case STATE_FALLING_PIXEL:
             if(!longPress) {    // short press Button B
-                FallingPixel_Spawn(1);  // drops 1 pixel
-                Serial.println("[ACTION] Drops One Pixel");
+                FallingPixel_Spawn(effects.fall, 1);    // drops 1 pixel
+                LOG("[ACTION] Drops One Pixel");
                 }
             else {              // long press Button B
                 uint8_t numPixels = random(8, 10);   // drops 8-10 pixel so that it could fill fasters, testing phase
-                FallingPixel_Spawn(numPixels);
-                Serial.println("[ACTION] Drops Multiple Pixels");
+                FallingPixel_Spawn(effects.fall, numPixels);
+                LOG("[ACTION] Drops Multiple Pixels");
+            }
+            break;
+#endif
+
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:
+            if (!longPress) {   // Short press
+                Aurora_NextHue(effects.aurora);     // shift the curtains to the next hue band
+                LOG("[ACTION] Aurora hue shifted");
+            }
+            else {              // long press
+                LOG("[BTN] Button B long press ignored in this state");
+            }
+            break;
+#endif
+
+#if LUMA_FEATURE_SCRIPT
+        case STATE_SCRIPT:      // both presses go to the program (VM_BTN)
+            Vm_Button(longPress ? VM_BUTTON_B_HOLD : VM_BUTTON_B_TAP);
+            break;
+#endif
+        default:
+            LOG("[BTN] Button B ignored in this state");
+            break;
+    }
+}
+
+// Gestures : taps and holds keep their button handlers above, everything else a state has to declare in getStateGestures()
+void LumaFSM::onGesture(Gesture gesture, uint16_t eventId) {
+    switch (gesture) {
+        case GESTURE_A_TAP:  onButtonAPressed(false, eventId); return;
+        case GESTURE_A_HOLD: onButtonAPressed(true, eventId);  return;
+        case GESTURE_B_TAP:  onButtonBPressed(false, eventId); return;
+        case GESTURE_B_HOLD: onButtonBPressed(true, eventId);  return;
+        default: break;
+    }
+
+    if (eventId) inputEvent = eventId;  // the next shown frame carries the result of this gesture
+
+    const char* gestureNames[] = {      // same order as Gesture
+        "A TAP", "A HOLD", "A DOUBLE", "A TRIPLE", "A REPEAT",
+        "B TAP", "B HOLD", "B DOUBLE", "B TRIPLE", "B REPEAT",
+        "CHORD", "CHORD HOLD"
+    };
+    static_assert(sizeof(gestureNames) / sizeof(gestureNames[0]) == GESTURE_COUNT, "gestureNames out of sync with Gesture");
+
+    LOG_PART("[GESTURE] ");
+    LOG(gestureNames[gesture]);
+
+    switch (currentState) {
+
+        case STATE_DEVICE_MENU:
+            if (gesture == GESTURE_CHORD) {     // A+B steps the menu back
+                selectedMenuOption = (MenuOption)((selectedMenuOption + MENU_COUNT - 1) % MENU_COUNT);
+                Scroller_Start(menuLabel, menuNames[selectedMenuOption], TUNE(label_ms));
+                LOG_PART("[ACTION] Menu cycled back -> ");
+                LOG(menuNames[selectedMenuOption]);
+            }
+            break;
+
+#if LUMA_FEATURE_COLOR_FLOOD
+        case STATE_COLOR_FLOOD:
+            if (gesture == GESTURE_B_REPEAT) {  // hold B keeps injecting floods, faster the longer it is held
+                ColorFlood_StartNew(effects.flood);
             }
             break;
+#endif
+
+#if LUMA_FEATURE_FALLING_PIXEL
+        case STATE_FALLING_PIXEL:
+            if (gesture == GESTURE_A_DOUBLE) {  // double tap A empties the board
+                FallingPixel_Init(effects.fall, LAYER_FALL_TRAIL, LAYER_FALL_SETTLED);
+                LOG("[ACTION] Falling Pixel board cleared");
+            }
+            else if (gesture == GESTURE_CHORD) {
+                LOG("[ACTION] Menu <- Falling Pixel (A+B)");
+                transitionTo(STATE_DEVICE_MENU);
+            }
+            break;
+#endif
+
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:
+            if (gesture == GESTURE_B_REPEAT) {  // hold B sweeps through the hue bands
+                Aurora_NextHue(effects.aurora);
+            }
+            break;
+#endif
+
         default:
-            Serial.println("[BTN] Button B ignored in this state");
             break;
     }
 }
 
+/**
+ * @brief Optional gestures the current state consumes
+ * The recognizer only holds a tap back to wait for a double / triple tap when the state declares one
+ *
+ */
+uint16_t LumaFSM::getStateGestures() const {
+    switch (currentState) {
+        case STATE_DEVICE_MENU:     return GESTURE_BIT(GESTURE_CHORD);
+#if LUMA_FEATURE_COLOR_FLOOD
+        case STATE_COLOR_FLOOD:     return GESTURE_BIT(GESTURE_B_REPEAT);
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+        case STATE_FALLING_PIXEL:   return GESTURE_BIT(GESTURE_A_DOUBLE) | GESTURE_BIT(GESTURE_CHORD);
+#endif
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:          return GESTURE_BIT(GESTURE_B_REPEAT);
+#endif
+        default:                    return 0;
+    }
+}
+
 // ==================== State Handlers (These are functions that run) ====================
+// Boot choreography : every phase of the TV bars is a track, the handler only draws what the tracks say
+enum BootTrack { BOOT_REVEAL, BOOT_COLLAPSE, BOOT_LEVEL };
+
+static const Keyframe BOOT_REVEAL_KEYS[] = {        // pixels revealed, column by column (HEIGHT per column)
+    {    0, 0,        EASE_LINEAR },
+    { 2000, NUM_LEDS, EASE_LINEAR },                // 250ms per column on the 8x8
+    { 4000, NUM_LEDS, EASE_LINEAR }                 // Signal Hold for 2s
+};
+static const Keyframe BOOT_COLLAPSE_KEYS[] = {      // pixels switched off by the glitch exit
+    {    0, 0,        EASE_LINEAR },
+    { 4000, 0,        EASE_LINEAR },
+    { 5500, NUM_LEDS, EASE_IN }                     // starts with a few glitches and speeds up
+};
+static const Keyframe BOOT_LEVEL_KEYS[] = {         // palette level of the bars
+    {    0, 255, EASE_LINEAR },
+    { 4000, 255, EASE_LINEAR },
+    { 5500, 140, EASE_OUT }                         // the signal weakens while it collapses
+};
+static const Track BOOT_TRACKS[] = { TRACK(BOOT_REVEAL_KEYS), TRACK(BOOT_COLLAPSE_KEYS), TRACK(BOOT_LEVEL_KEYS) };
+static const Timeline BOOT_TIMELINE = TIMELINE(BOOT_TRACKS);
+
+static_assert(STATE_ERROR < CLOCK_COUNT, "every state needs its own clock");
+static_assert(sizeof(LumaFSM) - sizeof(EffectContext) <= MEM_BUDGET_FSM, "LumaFSM exceeds MEM_BUDGET_FSM");
+
 /**
  * @brief Description of the start up animation TV bars
  * 
@@ -187,159 +443,144 @@ void LumaFSM::onButtonBPressed(bool longPress) {
  * 2. Signal Hold - Pattern stays visible briefly 
  * 3. Signal Collapse - Glitch exit Random pixel turn off, image collapse organically  
  * 
+ * The timing of all 3 phases is the BOOT_TIMELINE data above.
+ * A "boot" sequence in the flipbook partition replaces the bars - it is decoded straight from flash
  */
 void LumaFSM::handleState_DeviceOn() {
+    TRACE_SPAN("LumaFSM::handleState_DeviceOn");
     unsigned long elapsed = getStateElapsedTime();    // Starts the state timer
-    
-    const unsigned long STEP_MS = 250;                // Time alloted per column | Every 250ms next column starts
-    const unsigned long ROW_MS  = 150;                // Time per row within column | Controls vertical sweep feel
 
-    int colStep = elapsed / STEP_MS;                  //  Counts the Columns (phase 1)
+    if (elapsed == 0 || !bootPlayer.timeline) {       // first frame of the boot
+        Timeline_Start(bootPlayer, BOOT_TIMELINE);
+        Flipbook_Open(bootFlip, "boot", elapsed);
+        offCount = 0;
+    }
 
-    static unsigned long holdStart = 0;               // variable for holding signal (phase 2) 
-    
-    static bool collapse_start = false;               // flag variable for collapse exit (phase 3)
-    static uint8_t offCount = 0;                      // holds count of off leds (phase 3)
-
-    uint32_t bars[8] = {                  // Color of the bars
-        matrix.ColorHSV(0,     0,   10),  // White
-        matrix.ColorHSV(9000,  255, 10),  // Yellow
-        matrix.ColorHSV(30000, 255, 10),  // Cyan
-        matrix.ColorHSV(20000, 255, 10),  // Green
-        matrix.ColorHSV(50000, 255, 10),  // Magenta
-        matrix.ColorHSV(0,     255, 10),  // Red
-        matrix.ColorHSV(42000, 255, 10),  // Blue
-        matrix.ColorHSV(0,     0,   10)   // Black
-    };
+    if (bootFlip.sequence) {    // opened -> the flipbook owns the palette & framebuffer until its last frame
+        if (!Flipbook_Update(bootFlip, elapsed)) transitionTo(STATE_DEVICE_SCREENSAVER);
+        return;
+    }
 
-    // Phase 2 and Phase 3
-    if (colStep >= WIDTH) {                             // When all the columns are printed completely
-        if (!collapse_start) {                          // Hold final image Phase 2
-            if (holdStart == 0) holdStart = millis();   // start hold timer
+    // Bars live in palette entries 1-8 and index 0 is black -> the 8 colors are computed once, not every frame
+    if (Palette_Acquire(PALETTE_OWNER_BOOT)) {
+        Rgb16 bars[8] = {                     // Color of the bars
+            Color_HSV(0,     0,   74),        // White
+            Color_HSV(9000,  255, 74),        // Yellow
+            Color_HSV(30000, 255, 74),        // Cyan
+            Color_HSV(20000, 255, 74),        // Green
+            Color_HSV(50000, 255, 74),        // Magenta
+            Color_HSV(0,     255, 74),        // Red
+            Color_HSV(42000, 255, 74),        // Blue
+            Color_HSV(0,     0,   74)         // Black
+        };
+        Palette_Set(0, RGB16_BLACK);
+        for (int c = 0; c < 8; c++) Palette_Set(c + 1, bars[c]);
+    }
 
-            if (millis() - holdStart < 2000) {          // Holding image for 2s
-                matrix.show();
-                return;
-            }
+    bool running = Timeline_Tick(bootPlayer, elapsed);
+    int revealed = Timeline_Value(bootPlayer, BOOT_REVEAL);
+    int switchedOff = Timeline_Value(bootPlayer, BOOT_COLLAPSE);
+    Palette_SetLevel(Timeline_Value(bootPlayer, BOOT_LEVEL));
 
-            // Start Phase 3 collapse exit and resetting counters
-            collapse_start = true;
-            offCount = 0;
-            holdStart = 0;
-        }
+    if (switchedOff == 0) {     // Phase 1 and Phase 2
+        int colStep = revealed / HEIGHT;    // fully revealed columns
+        int rowStep = revealed % HEIGHT;    // progress of the column being revealed
 
-        // Signal Collapse exit Phase 3
-        for (int k = 0; k < 3; k++) {       // each frame kills 3 leds | increase the value for faster collapse
-            int r = random(0, HEIGHT);      // randomly selects the row and column   
-            int c = random(0, WIDTH);
-            int idx = pixelIndex(r, c);
+        Palette_Clear();    // clears frame buffer before drawing
 
-            if (matrix.getPixelColor(idx) != 0) {   // Only turn off if still on
-                matrix.setPixelColor(idx, 0);
-                offCount++;
+        // Fully revealed columns - if we remove this loop then the revealed columns won't hold their colors thats why its necessary to redraw all the revealed columns
+        for (int c = 0; c < colStep && c < WIDTH; c++) {
+            for (int r = 0; r < HEIGHT; r++) {
+                Palette_SetPixel(pixelIndex(r, c), c + 1);
             }
         }
-        matrix.show();
 
-        // Here either wait for all the 64 leds to turn off as i did below 
-        // or multiply (WIDTH * HEIGHT) by 0.9 so around 57 leds are off the state will transition
-        if (offCount >= (WIDTH * HEIGHT)) {
-            collapse_start = false;
-            transitionTo(STATE_DEVICE_SCREENSAVER);
+        if (colStep < WIDTH) {  // Currently revealing column - row progression in column
+            for (int i = 0; i <= rowStep; i++) {
+                int r = (colStep % 2 == 0) ? i : (HEIGHT - 1 - i);  // for even columns the row progressions starts from top to bottom and for odd bottom to top
+                Palette_SetPixel(pixelIndex(r, colStep), colStep + 1);
+            }
         }
-        return;
     }
+    else {                      // Phase 3 - Signal Collapse, switch off leds until the track count is reached
+        while (offCount < switchedOff) {
+            int idx = random(0, NUM_LEDS);                  // random led, if it is already off take the next one still on
+            for (int n = 0; n < NUM_LEDS && Palette_GetPixel(idx) == 0; n++) idx = (idx + 1) % NUM_LEDS;
 
-    // Phase 1
-    matrix.clear();     // clears frame buffer before drawing
-
-    // Fully revealed columns - if we remove this loop then the revealed columns won't hold their colors thats why its necessary to redraw all the revealed columns
-    for (int c = 0; c < colStep && c < WIDTH; c++) {
-        for (int r = 0; r < HEIGHT; r++) {
-            matrix.setPixelColor(pixelIndex(r, c), bars[c]);
+            Palette_SetPixel(idx, 0);
+            offCount++;
         }
     }
 
-    if (colStep < WIDTH) {  // Currently revealing column - row progression in column
-        int rowStep = ((elapsed % STEP_MS) * HEIGHT) / STEP_MS; // Row progression and it scales from 0...7
-
-        for (int i = 0; i <= rowStep && i < HEIGHT; i++) {
-            int r = (colStep % 2 == 0) ? i : (HEIGHT - 1 - i);  // for even columns the row progressions starts from top to bottom and for odd bottom to top
-            matrix.setPixelColor(pixelIndex(r, colStep), bars[colStep]);
-        }
+    if (!running) {             // last keyframe reached -> all leds are off
+        transitionTo(STATE_DEVICE_SCREENSAVER);
     }
-    matrix.show();
 }
 
 void LumaFSM::handleState_DeviceScreensaver() {
+    TRACE_SPAN("LumaFSM::handleState_DeviceScreensaver");
 
     // Infinite state, waiting for button press
     // Button B short press -> make orb explode
     // Button A short press -> MENU (handled in onButtonAPressed)
     // Button B/A long press -> No action
 
-    static unsigned long lastStep = 0;
-    static int pxRow = HEIGHT / 2;          // the pixel orb sstarts at (4,0)
-    static int pxCol = 0;
-    static uint32_t pxColor = matrix.ColorHSV(40000, 255, 10);  // pixel orb color
-
-    const unsigned long MOVE_MS    = 100;  // controls the speed of pixel in idle animation  low value -> higher speed and vice versa
-    const unsigned long VIBRATE_MS = 300;  // this controls the vibrate phase
-
     // === MOVE ===
-    if (phase == MOVE) {    // Moving animation loop
-
-        if (millis() - lastStep < MOVE_MS) return;  // Frame Control Rate 1000ms / 100ms -> 10FPS
-
-        lastStep = millis();
-
-        matrix.clear();
-        matrix.setPixelColor(pixelIndex(pxRow, pxCol), pxColor);    // start pixel at 4,0
-        matrix.show();
-
-        pxCol++;            // Move the orb to the right column
-        if (pxCol >= WIDTH) // If the orb reached the end wrap around
-            pxCol = 0;      // start from column 0
-
+    if (phase == MOVE) {    // Drifting orb - moves a little every tick (50FPS) at sub-pixel positions
+        Orb_Update(effects.orb, effects.view, LAYER_SAVER);
+        Canvas_Render(effects.view, LAYER_WORLD);   // only draws when the camera panned
         return;
     }
 
-    // === VIBRATE ===
-    if (phase == VIBRATE) { // feedback phase triggered by Button B short press micro anticipation before the explosion
+    // === HIT === vibrate + explode, triggered by Button B short press
+    if (phase == HIT) {
 
-        if (millis() - phaseStart > VIBRATE_MS) {   // if vibrate phase done then explode
-            startPixelExplosion(pxRow, pxCol);
-            phase = EXPLODE;
-            return;
+        updateOrbHit(effects.hit, LAYER_SAVER);     // Timeline drives the vibrate and the explosion
+        if (isOrbHitDone(effects.hit)) {            // if explosion done choose new starting point, direction and color
+            Orb_Respawn(effects.orb, effects.view);
+            phase = MOVE;
         }
+    }
+}
 
-        // in vibrate phase creating micro jitter to build for explosion 
-        matrix.clear();
-        int vr = pxRow + random(-1, 2); // this micro anticipation jitter will be of 3x3 matrix -1,0,1
-        int vc = pxCol + random(-1, 2);
+/**
+ * @brief Steps the preview of one menu option, each preview throttles itself and draws into its own layer
+ *
+ */
+void LumaFSM::drawMenuPreview(MenuOption option) {
+    switch (option)     // switch Menu Options
+    {
+#if LUMA_FEATURE_COLOR_FLOOD
+        case MENU_COLOR_FLOOD:
+        drawMenu_ColorFlood(effects.floodPreview, LAYER_MENU_FLOOD);    // color flood preview
+        break;
+#endif
 
-        if (vr >= 0 && vr < HEIGHT && vc >= 0 && vc < WIDTH) {  // Bounding checking vr and vc
-            matrix.setPixelColor(pixelIndex(vr, vc), pxColor);
-        }
-        matrix.show();
-        return;
-    }
+#if LUMA_FEATURE_FALLING_PIXEL
+        case MENU_FALLING_PIXELS:
+        drawMenu_FallingPixel(effects.fallPreview, LAYER_MENU_FALL);    // falling pixels preview
+        break;
+#endif
 
-    // === EXPLODE ===
-    if (phase == EXPLODE) {             // Explosion 
+#if LUMA_FEATURE_AURORA
+        case MENU_AURORA:
+        drawMenu_Aurora(effects.aurora, LAYER_MENU_AURORA);             // aurora preview
+        break;
+#endif
 
-        updatePixelExplosion();         // Continously update the Explosion animation
-        if (isExplosionDone()) {        // if explosion done choose new starting point
-            pxRow = random(0, HEIGHT);  // choose random origin coordinates
-            pxCol = random(0, WIDTH);
+#if LUMA_FEATURE_SCRIPT
+        case MENU_SCRIPT:
+        Vm_Update();                // the program itself is the preview
+        break;
+#endif
 
-            pxColor = matrix.ColorHSV(random(0, 65535), 255, 10); // change color
-            phase = MOVE;
-        }
+        default:
+        break;
     }
 }
 
 void LumaFSM::handleState_DeviceMenu() {
+    TRACE_SPAN("LumaFSM::handleState_DeviceMenu");
     // Infinite state, showing current menu option
     // Button B short press -> cycle menu
     // Button B long press -> select menu
@@ -349,95 +590,335 @@ void LumaFSM::handleState_DeviceMenu() {
     // Optional: Print current selection periodically (every 2 seconds)
     unsigned long elapsed = getStateElapsedTime();
     if (elapsed % 2000 < 20) { // Trigger once per 2 seconds
-        Serial.print("[STATE_MENU] Selected: ");
-        Serial.println(menuNames[selectedMenuOption]);
+        LOG_PART("[STATE_MENU] Selected: ");
+        LOG(menuNames[selectedMenuOption]);
     }
 
-    switch (selectedMenuOption)     // switch Menu Options
-    {
-        case MENU_COLOR_FLOOD:
-        drawMenu_ColorFlood();      // color flood preview
-        break;
+    // Every preview keeps animating in its own layer, so cycling with Button B shows a warm frame straight away.
+    // The selected preview gets a step every tick, the others take turns - one background step per tick keeps the cost bounded
 
-        case MENU_FALLING_PIXELS:
-        drawMenu_FallingPixel();    // falling pixels preview
-        break;
+    drawMenuPreview(selectedMenuOption);
 
-        default:
-        break;
+    if (MENU_COUNT > 1) {
+        backgroundPreview = (backgroundPreview + 1) % MENU_COUNT;
+        if (backgroundPreview == selectedMenuOption) backgroundPreview = (backgroundPreview + 1) % MENU_COUNT;
+        drawMenuPreview((MenuOption)backgroundPreview);
+    }
+
+    // Label of the option on top of the preview - only redrawn when it scrolls by one column
+    if (Scroller_Update(menuLabel)) {
+        Layer_BeginFrame(LAYER_TEXT);
+        Scroller_Draw(menuLabel, LAYER_TEXT, HEIGHT - FONT_HEIGHT, LABEL_COLOR);
     }
 
 }
 
+#if LUMA_FEATURE_COLOR_FLOOD
 // ===== Color Flood State Handlers =====
-static bool colorFloodInit = false; // Color Flood Initializing Flag for first entry
 void LumaFSM::handleState_ColorFlood() {
+    TRACE_SPAN("LumaFSM::handleState_ColorFlood");
 
-    if (!colorFloodInit) {      // Initialize Color Flood
-        ColorFlood_Init();
+    if (!colorFloodInit) {      // Initialize Color Flood on first entry
+        ColorFlood_Init(effects.flood, LAYER_FLOOD);
         colorFloodInit = true;  
     }
 
-    ColorFlood_Update();    // Animation Engine of Color Flood Called every 20ms according to the main FSM
+    ColorFlood_Update(effects.flood, LAYER_FLOOD);    // Animation Engine of Color Flood Called every 20ms according to the main FSM
 }
+#endif
 
+#if LUMA_FEATURE_FALLING_PIXEL
 // ===== Falling Pixel State Handlers =====
-static bool fallingpixel_init = false;  // Falling Pixel Initializing Flag on first entry
 void LumaFSM::handleState_FallingPixel() {
+    TRACE_SPAN("LumaFSM::handleState_FallingPixel");
 
-    if (!fallingpixel_init) {   // Initialize Falling Pixels
-        FallingPixel_Init();
-        fallingpixel_init = true;
+    if (!fallingPixelInit) {    // Initialize Falling Pixels on first entry
+        FallingPixel_Init(effects.fall, LAYER_FALL_TRAIL, LAYER_FALL_SETTLED);
+        fallingPixelInit = true;
     }
 
-    FallingPixel_Update();  // Animation Engine of Falling Pixel Called every 20ms according to the main FSM  
+    FallingPixel_Update(effects.fall, LAYER_FALL_TRAIL, LAYER_FALL_SETTLED);  // Animation Engine of Falling Pixel Called every 20ms according to the main FSM  
 
-    if (FallingPixel_IsFull()) {    // If the matrix full proceed to Explosion 
-        FallingPixel_Explosion();
+    if (FallingPixel_IsFull(effects.fall) && !FallingPixel_InFinale(effects.fall)) {    // If the matrix full proceed to Explosion 
+        FallingPixel_Explosion(effects.fall, LAYER_FALL_TRAIL);     // plays over the next frames, the loop keeps running
     }
 }
+#endif
+
+#if LUMA_FEATURE_AURORA
+// ===== Aurora State Handlers =====
+void LumaFSM::handleState_Aurora() {
+    TRACE_SPAN("LumaFSM::handleState_Aurora");
+
+    if (!auroraInit) {          // Initialize Aurora on first entry
+        Aurora_Init(effects.aurora);
+        auroraInit = true;
+    }
+
+    Aurora_Update(effects.aurora);        // Noise field is sampled every 20ms according to the main FSM -> full 50FPS
+}
+#endif
+
+#if LUMA_FEATURE_SCRIPT
+// ===== Script State Handlers =====
+void LumaFSM::handleState_Script() {
+    TRACE_SPAN("LumaFSM::handleState_Script");
+
+    if (!scriptInit) {          // Program starts over on every entry
+        Vm_Start();
+        scriptInit = true;
+    }
+
+    Vm_Update();            // runs a frame of the program when its own period is due
+}
+#endif
 
 // ==================== Transition Handler ====================
 void LumaFSM::transitionTo(LumaState newState) {
     if (newState != currentState) {
+        startCrossfade(getStateLayers());   // freeze the outgoing frame before the state changes
         currentState = newState;
+        Clock_Select(currentState);         // effects of the new state run on its clock from here on
+    }
+
+    if (currentState == STATE_DEVICE_MENU) {    // show the label of the selected option again
+        Scroller_Start(menuLabel, menuNames[selectedMenuOption], TUNE(label_ms));
     }
 
     // Commenting this below part so that user can resume the falling pixel page from where it left from
     // when leaving falling pixel page, reset the flag so the user start with clear matrix
     // if (currentState == STATE_FALLING_PIXEL) { 
-    //     fallingpixel_init = false;
+    //     fallingPixelInit = false;
     // }
 
+#if LUMA_FEATURE_COLOR_FLOOD
     if (currentState != STATE_COLOR_FLOOD) {    // Color Flood will start from fresh if you left the page and came back
         colorFloodInit = false;
     }
+#endif
+
+#if LUMA_FEATURE_AURORA
+    if (currentState != STATE_AURORA) {         // Aurora clears the matrix again on the next entry
+        auroraInit = false;
+    }
+#endif
+
+#if LUMA_FEATURE_SCRIPT
+    if (currentState != STATE_SCRIPT) {
+        scriptInit = false;
+    }
+#endif
+}
+
+// ==================== Snapshots ====================
+/**
+ * @brief true if a stored state can be entered directly in this build profile
+ *
+ */
+static bool isRestorable(uint8_t state) {
+    switch (state) {
+        case STATE_DEVICE_SCREENSAVER:
+        case STATE_DEVICE_MENU:         return true;
+#if LUMA_FEATURE_COLOR_FLOOD
+        case STATE_COLOR_FLOOD:         return true;
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+        case STATE_FALLING_PIXEL:       return true;
+#endif
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:              return true;
+#endif
+#if LUMA_FEATURE_SCRIPT
+        case STATE_SCRIPT:              return true;
+#endif
+        default:                        return false;
+    }
+}
+
+/**
+ * @brief Packs the current state - the boot animation is stored as the screensaver it ends in
+ *
+ */
+void LumaFSM::offerSnapshot() {
+    Snapshot snapshot;
+    snapshot.state = isRestorable(currentState) ? currentState : STATE_DEVICE_SCREENSAVER;
+    snapshot.menuOption = selectedMenuOption;
+#if LUMA_FEATURE_FALLING_PIXEL
+    snapshot.boardLength = FallingPixel_Pack(effects.fall, snapshot.board);
+#else
+    snapshot.boardLength = 0;
+#endif
+    Snapshot_Offer(snapshot, Clock_Uptime());
+}
+
+/**
+ * @brief Restores the menu option and the Falling Pixel board of the last snapshot
+ * With fast boot the boot animation is skipped and the stored state fades in straight away
+ */
+void LumaFSM::restoreSnapshot() {
+    Snapshot snapshot;
+    if (!Snapshot_Load(snapshot)) return;
+
+    if (snapshot.menuOption < MENU_COUNT) selectedMenuOption = (MenuOption)snapshot.menuOption;
+
+#if LUMA_FEATURE_FALLING_PIXEL
+    if (snapshot.boardLength && FallingPixel_Unpack(effects.fall, snapshot.board, snapshot.boardLength, LAYER_FALL_TRAIL, LAYER_FALL_SETTLED)) {
+        fallingPixelInit = true;   // same as coming back from the menu - the board is kept
+    }
+#endif
+
+    if (Snapshot_FastBoot() && isRestorable(snapshot.state)) {
+        LOG("[FSM] Fast boot - restoring the last state");
+        transitionTo((LumaState)snapshot.state);
+    }
+}
+
+// ==================== Compositor Layers ====================
+/**
+ * @brief Layers that make up the frame of the current state
+ * Each state handler only draws into its own layers, the compositor blends them in one pass
+ *
+ * @return uint16_t LAYER_BIT() mask for Compositor_Present
+ */
+uint16_t LumaFSM::getStateLayers() const {
+    switch (currentState) {
+        case STATE_DEVICE_ON:           return LAYER_BIT(LAYER_PALETTE);
+        case STATE_DEVICE_SCREENSAVER:  return LAYER_BIT(LAYER_WORLD) | LAYER_BIT(LAYER_SAVER);
+#if LUMA_FEATURE_COLOR_FLOOD
+        case STATE_COLOR_FLOOD:         return LAYER_BIT(LAYER_FLOOD);
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+        case STATE_FALLING_PIXEL:       return LAYER_BIT(LAYER_FALL_TRAIL) | LAYER_BIT(LAYER_FALL_SETTLED);
+#endif
+#if LUMA_FEATURE_AURORA
+        case STATE_AURORA:              return LAYER_BIT(LAYER_PALETTE);
+#endif
+#if LUMA_FEATURE_SCRIPT
+        case STATE_SCRIPT:              return LAYER_BIT(LAYER_SCRIPT);
+#endif
+
+        case STATE_DEVICE_MENU:         // preview of the selected option with its label on top
+            switch (selectedMenuOption) {
+#if LUMA_FEATURE_COLOR_FLOOD
+                case MENU_COLOR_FLOOD:      return LAYER_BIT(LAYER_MENU_FLOOD) | LAYER_BIT(LAYER_TEXT);
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+                case MENU_FALLING_PIXELS:   return LAYER_BIT(LAYER_MENU_FALL)  | LAYER_BIT(LAYER_TEXT);
+#endif
+#if LUMA_FEATURE_AURORA
+                case MENU_AURORA:           return LAYER_BIT(LAYER_MENU_AURORA) | LAYER_BIT(LAYER_TEXT);
+#endif
+#if LUMA_FEATURE_SCRIPT
+                case MENU_SCRIPT:           return LAYER_BIT(LAYER_SCRIPT) | LAYER_BIT(LAYER_TEXT);
+#endif
+                default:                    return LAYER_BIT(LAYER_TEXT);
+            }
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Layers that show the result of a button action in the current state
+ * The state layers without the backdrop that keeps changing on its own (the screensaver world pans with the orb),
+ * a frame only closes the latency event once one of these was redrawn
+ *
+ * @return uint16_t LAYER_BIT() mask, a subset of getStateLayers()
+ */
+uint16_t LumaFSM::getInputLayers() const {
+    return getStateLayers() & ~LAYER_BIT(LAYER_WORLD);
+}
+
+// ==================== State Crossfade ====================
+#define CROSSFADE_FRAMES 12     // 12 x 20ms -> ~240ms blend between two states
+#define CROSSFADE_VISIBLE 64    // blend amount from which the new state counts as shown (latency) - frame 4 of 12, frame 1 is ~2%
+
+static inline uint8_t crossfadeAmount(uint8_t frame) {
+    return ease8(EASE_IN_OUT, frame * 255 / CROSSFADE_FRAMES);
+}
+
+/**
+ * @brief Starts blending from the current frame to the next state
+ * The outgoing frame is resolved once into an offscreen target, targets come from the fixed pool.
+ * If a crossfade is still running the blend last shown becomes the outgoing frame, so A -> B -> A
+ * turns around where it is instead of jumping. If the pool is empty the transition is simply a cut
+ *
+ * @param outgoingLayers Layers of the state being left
+ */
+void LumaFSM::startCrossfade(uint16_t outgoingLayers) {
+    if (fadeFrom) {                 // interrupted -> fadeTo still holds the last frame of the state being left
+        Compositor_ResolveBlend(*fadeFrom, *fadeTo, crossfadeAmount(fadeFrame));
+        fadeFrame = 0;
+        return;
+    }
+
+    fadeFrom = RenderTarget_Acquire();
+    fadeTo   = RenderTarget_Acquire();
+
+    if (!fadeFrom || !fadeTo) {     // no offscreen frames available -> cut
+        RenderTarget_Release(fadeFrom);
+        RenderTarget_Release(fadeTo);
+        fadeFrom = fadeTo = nullptr;
+        return;
+    }
+
+    Compositor_Resolve(outgoingLayers, *fadeFrom);
+    fadeFrame = 0;
+}
+
+/**
+ * @brief Sends the current frame to the matrix
+ * Normally a plain composite of the state layers, during a crossfade the new state is resolved
+ * offscreen and blended with the frozen outgoing frame - same single show() per tick, no extra stall
+ */
+void LumaFSM::presentFrame() {
+    if (!fadeFrom) {
+        uint16_t shown = Compositor_Present(getStateLayers());
+        if (inputEvent && (shown & getInputLayers())) {
+            Latency_Photon(inputEvent);     // the layers that carry the input were redrawn and are on the LEDs
+            inputEvent = 0;
+        }
+        return;
+    }
+
+    Compositor_Resolve(getStateLayers(), *fadeTo);
+    fadeFrame++;
+    uint8_t amount = crossfadeAmount(fadeFrame);
+    Compositor_PresentBlend(*fadeFrom, *fadeTo, amount);
+    if (inputEvent && amount >= CROSSFADE_VISIBLE) {
+        Latency_Photon(inputEvent);         // the new state is far enough into the blend to be seen
+        inputEvent = 0;
+    }
+
+    if (fadeFrame >= CROSSFADE_FRAMES) {    // done -> targets go back to the pool
+        RenderTarget_Release(fadeFrom);
+        RenderTarget_Release(fadeTo);
+        fadeFrom = fadeTo = nullptr;
+    }
 }
 
 // ==================== Utilities (Used for Serial Debugging) ====================
 unsigned long LumaFSM::getStateElapsedTime() const {
-    return millis() - stateStartTime;
+    return Clock_Now() - stateStartTime;
 }
 
 void LumaFSM::logStateTransition(LumaState from, LumaState to) {    
-    const char* stateNames[] = {
+    const char* stateNames[] = {    // same order as LumaState
         "DEVICE_ON",
         "SCREENSAVER",
         "MENU",
-        "SELECT_TIME",
-        "COUNTDOWN",
-        "RUNNING",
-        "PAUSED",
-        "FINISHED",
-        "THEMES",
+        "COLOR FLOOD",
         "FALLING PIXEL",
+        "AURORA",
+        "SCRIPT",
         "ERROR"
     };
     
-    Serial.print("[TRANSITION] ");
-    Serial.print(stateNames[from]);
-    Serial.print(" -> ");
-    Serial.println(stateNames[to]);
+    LOG_PART("[TRANSITION] ");
+    LOG_PART(stateNames[from]);
+    LOG_PART(" -> ");
+    LOG(stateNames[to]);
 }
 
 
@@ -0,0 +1,170 @@
+/**
+ * @file gesture.cpp
+ * @author sarvesh
+ * @brief Implementation of gesture.h
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "gesture.h"
+#include "memstats.h"
+#include "trace.h"
+
+struct ButtonTrack {
+    bool down;                  // level seen on the last poll
+    bool swallow;               // press already used by a chord or repeat -> its release reports nothing
+    uint8_t taps;               // taps collected while waiting for a double / triple tap
+    unsigned long downAt;       // when the current press started
+    unsigned long upAt;         // when the last tap was released
+    unsigned long nextRepeat;   // when the next repeat fires, 0 -> no repeat for this press
+    uint16_t repeatGap;         // current repeat interval
+};
+
+static ButtonTrack buttons[2];          // A, B
+static bool chordActive = false;        // both buttons went down together and are not both released yet
+static unsigned long chordAt = 0;       // when the chord started
+
+static Gesture queue[GESTURE_QUEUE];    // recognized gestures, ring buffer
+static uint8_t queueHead = 0;           // next gesture to pop
+static uint8_t queueCount = 0;          // gestures in the queue
+
+static_assert(sizeof(buttons) + sizeof(queue) <= MEM_BUDGET_GESTURE, "gesture state exceeds MEM_BUDGET_GESTURE");
+
+// ==================== Helpers ====================
+/**
+ * @brief Queues a recognized gesture, dropped if the loop has not dispatched the earlier ones
+ *
+ */
+static void emit(Gesture gesture) {
+    if (queueCount >= GESTURE_QUEUE) return;
+    queue[(queueHead + queueCount) % GESTURE_QUEUE] = gesture;
+    queueCount++;
+}
+
+/**
+ * @brief Gesture of a button -> GESTURE_A_TAP / GESTURE_A_HOLD ... shifted to the button
+ *
+ */
+static inline Gesture forButton(uint8_t button, Gesture aGesture) {
+    return (Gesture)(aGesture + button * GESTURE_PER_BUTTON);
+}
+
+static inline bool consumes(uint16_t consumed, uint8_t button, Gesture aGesture) {
+    return consumed & GESTURE_BIT(forButton(button, aGesture));
+}
+
+/**
+ * @brief Reports the taps collected on a button
+ * Three taps are a triple, two a double - if the state does not consume that gesture the taps come out one by one
+ *
+ */
+static void flushTaps(uint8_t button, uint16_t consumed) {
+    uint8_t taps = buttons[button].taps;
+    buttons[button].taps = 0;
+
+    if (taps == 3 && consumes(consumed, button, GESTURE_A_TRIPLE)) { emit(forButton(button, GESTURE_A_TRIPLE)); return; }
+    if (taps >= 2 && consumes(consumed, button, GESTURE_A_DOUBLE)) { emit(forButton(button, GESTURE_A_DOUBLE)); taps -= 2; }
+    while (taps--) emit(forButton(button, GESTURE_A_TAP));
+}
+
+// ==================== Recognizer ====================
+/**
+ * @brief Advances the recognizer with the current button levels
+ *
+ * @param aDown Button A pressed
+ * @param bDown Button B pressed
+ * @param consumed GESTURE_BIT() of the optional gestures the current state handles
+ * @param now Timestamp in ms
+ */
+void Gesture_Update(bool aDown, bool bDown, uint16_t consumed, unsigned long now) {
+    TRACE_SPAN("Gesture_Update");
+    bool level[2] = { aDown, bDown };
+
+    for (uint8_t i = 0; i < 2; i++) {
+        ButtonTrack &t = buttons[i];
+        ButtonTrack &other = buttons[1 - i];
+
+        if (level[i] && !t.down) {                  // ---- pressed
+            t.down = true;
+            t.swallow = false;
+            t.downAt = now;
+            t.nextRepeat = consumes(consumed, i, GESTURE_A_REPEAT) ? now + GESTURE_REPEAT_DELAY_MS : 0;
+            t.repeatGap = GESTURE_REPEAT_START_MS;
+
+            if (other.down && !chordActive && (consumed & (GESTURE_BIT(GESTURE_CHORD) | GESTURE_BIT(GESTURE_CHORD_HOLD)))) {
+                chordActive = true;                 // second button joined -> both presses belong to the chord
+                chordAt = other.downAt;
+                t.swallow = other.swallow = true;
+                t.taps = other.taps = 0;
+            }
+        }
+        else if (level[i] && t.down) {              // ---- held
+            if (t.nextRepeat && !chordActive && (long)(now - t.nextRepeat) >= 0) {
+                flushTaps(i, consumed);
+                emit(forButton(i, GESTURE_A_REPEAT));
+                t.swallow = true;
+                t.nextRepeat = now + t.repeatGap;
+                t.repeatGap = t.repeatGap * 3 / 4;  // accelerate
+                if (t.repeatGap < GESTURE_REPEAT_MIN_MS) t.repeatGap = GESTURE_REPEAT_MIN_MS;
+            }
+        }
+        else if (!level[i] && t.down) {             // ---- released
+            t.down = false;
+            unsigned long duration = now - t.downAt;
+
+            if (t.swallow) {
+                if (chordActive && !other.down) {   // last button of the chord let go
+                    chordActive = false;
+                    emit(now - chordAt > GESTURE_LONG_MS ? GESTURE_CHORD_HOLD : GESTURE_CHORD);
+                }
+            }
+            else if (duration <= GESTURE_DEBOUNCE_MS) {
+                // noise
+            }
+            else if (duration > GESTURE_LONG_MS) {
+                flushTaps(i, consumed);
+                emit(forButton(i, GESTURE_A_HOLD));
+            }
+            else {
+                t.taps++;
+                t.upAt = now;
+
+                uint8_t maxTaps = consumes(consumed, i, GESTURE_A_TRIPLE) ? 3 : consumes(consumed, i, GESTURE_A_DOUBLE) ? 2 : 1;
+                if (t.taps >= maxTaps) flushTaps(i, consumed);  // nothing longer to wait for -> no added latency
+            }
+        }
+        else if (t.taps && now - t.upAt > GESTURE_TAP_GAP_MS) {    // ---- idle, tap window closed
+            flushTaps(i, consumed);
+        }
+    }
+}
+
+/**
+ * @brief Pops the next recognized gesture
+ *
+ * @return true if gesture was written
+ */
+bool Gesture_Next(Gesture &gesture) {
+    if (!queueCount) return false;
+
+    gesture = queue[queueHead];
+    queueHead = (queueHead + 1) % GESTURE_QUEUE;
+    queueCount--;
+    return true;
+}
+
+/**
+ * @brief Back to both buttons released and an empty queue
+ * For a new simulated device (stress runs) - a press in progress never reports its release
+ *
+ */
+void Gesture_Reset() {
+    memset(buttons, 0, sizeof(buttons));
+    chordActive = false;
+    chordAt = 0;
+    queueHead = 0;
+    queueCount = 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file latency.cpp
+ * @author sarvesh
+ * @brief Implementation of latency.h
+ * @version 1.0
+ * @date 2026-2-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "latency.h"
+#include "memstats.h"
+#include "profiles.h"
+
+struct PendingEvent {
+    uint16_t id;        // 0 -> free slot
+    uint8_t state;      // state the input was handled in
+    uint32_t edgeUs;    // GPIO edge of the press, or when a hold repeat was recognized
+};
+
+static volatile uint32_t edgeUs[2];             // last edge of each button, written by the ISRs
+static PendingEvent pending[LAT_PENDING];       // events waiting for a shown frame
+static uint16_t nextId = 1;                     // event id counter, 0 is reserved for "no event"
+
+static uint16_t histogram[LAT_STATES][LAT_BUCKETS];    // event counts per state and latency bucket
+static uint16_t worstMs[LAT_STATES];                   // slowest event per state
+static uint16_t lostEvents = 0;                        // events that never reached a shown frame
+
+static uint32_t loopStartUs = 0;        // start of the current loop iteration
+static uint32_t slowLoops = 0;          // iterations over LOOP_WARN_MS
+static uint32_t worstLoopMs = 0;        // slowest iteration seen
+
+static_assert(sizeof(pending) + sizeof(histogram) + sizeof(worstMs) <= MEM_BUDGET_LATENCY, "latency tables exceed MEM_BUDGET_LATENCY");
+
+// ==================== GPIO Edges ====================
+static void IRAM_ATTR onEdgeA() { edgeUs[LAT_BUTTON_A] = micros(); }
+static void IRAM_ATTR onEdgeB() { edgeUs[LAT_BUTTON_B] = micros(); }
+
+/**
+ * @brief Timestamps every edge of both buttons
+ * The actions fire on release, the last edge before pollButtons() sees the release is when the user let go
+ *
+ */
+void Latency_Init(int pinA, int pinB) {
+    attachInterrupt(digitalPinToInterrupt(pinA), onEdgeA, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(pinB), onEdgeB, CHANGE);
+}
+
+// ==================== Events ====================
+/**
+ * @brief Bucket of a latency -> bucket i holds everything below 4 << i ms
+ *
+ */
+static uint8_t bucketOf(uint32_t ms) {
+    uint8_t b = 0;
+    while (b < LAT_BUCKETS - 1 && ms >= (4UL << b)) b++;
+    return b;
+}
+
+/**
+ * @brief Adds one finished event to the histogram of its state
+ *
+ */
+static void record(const PendingEvent &e, uint32_t ms) {
+    uint16_t &count = histogram[e.state][bucketOf(ms)];
+    if (count < UINT16_MAX) count++;
+    if (ms > worstMs[e.state]) worstMs[e.state] = ms > UINT16_MAX ? UINT16_MAX : ms;
+}
+
+/**
+ * @brief Opens an input event for a button action that is about to be handled
+ * If every slot is taken the oldest event is given up and counted as lost
+ *
+ * @param button Button whose edge starts the measurement, LAT_BUTTON_NONE -> starts now
+ * @param state State that handles the input
+ * @return uint16_t id to hand to the FSM, never 0
+ */
+uint16_t Latency_Input(LatencyButton button, LumaState state) {
+    uint8_t slot = 0;
+    for (uint8_t i = 0; i < LAT_PENDING; i++) {
+        if (!pending[i].id) { slot = i; break; }
+        if ((int16_t)(pending[i].id - pending[slot].id) < 0) slot = i;     // oldest so far
+    }
+    if (pending[slot].id) lostEvents++;
+
+    pending[slot].id = nextId;
+    pending[slot].state = state;
+    if (button == LAT_BUTTON_BOTH) {
+        uint32_t a = edgeUs[LAT_BUTTON_A], b = edgeUs[LAT_BUTTON_B];
+        pending[slot].edgeUs = (int32_t)(a - b) > 0 ? a : b;
+    } else if (button == LAT_BUTTON_NONE) {
+        pending[slot].edgeUs = micros();
+    } else {
+        pending[slot].edgeUs = edgeUs[button];
+    }
+
+    if (++nextId == 0) nextId = 1;
+    return pending[slot].id;
+}
+
+/**
+ * @brief A frame was shown - every event up to eventId is on the LEDs now
+ *
+ * @param eventId Latest event the FSM handled before this frame
+ */
+void Latency_Photon(uint16_t eventId) {
+    uint32_t now = micros();
+
+    for (uint8_t i = 0; i < LAT_PENDING; i++) {
+        if (!pending[i].id || (int16_t)(eventId - pending[i].id) < 0) continue;    // free or newer than the frame
+
+        record(pending[i], (now - pending[i].edgeUs) / 1000);
+        pending[i].id = 0;
+    }
+}
+
+// ==================== Loop Watchdog ====================
+/**
+ * @brief Marks the start of a loop iteration
+ *
+ */
+void Latency_LoopBegin() {
+    loopStartUs = micros();
+}
+
+/**
+ * @brief Flags a slow loop iteration and retires events that never reached the LEDs
+ * An effect that blocks the loop (delays, long loops in one frame) shows up here
+ *
+ * @param state State that ran this iteration
+ */
+void Latency_LoopEnd(LumaState state) {
+    uint32_t now = micros();
+    uint32_t ms = (now - loopStartUs) / 1000;
+
+    if (ms > worstLoopMs) worstLoopMs = ms;
+    if (ms > LOOP_WARN_MS) {
+        slowLoops++;
+        LOG_PART("[WDT] loop took ");
+        LOG_PART(ms);
+        LOG_PART(" ms in state ");
+        LOG(state);
+    }
+
+    for (uint8_t i = 0; i < LAT_PENDING; i++) {
+        if (pending[i].id && now - pending[i].edgeUs > LAT_TIMEOUT_MS * 1000UL) {
+            pending[i].id = 0;
+            lostEvents++;
+        }
+    }
+}
+
+// ==================== Report ====================
+/**
+ * @brief Prints one histogram line per state that saw input
+ *
+ * @param args "reset" clears the statistics after printing
+ */
+void Latency_Print(const char *args) {
+    Serial.println("state : <4 <8 <16 <32 <64 <128 <256 >=256 ms | worst");
+
+    for (uint8_t s = 0; s < LAT_STATES; s++) {
+        uint32_t total = 0;
+        for (uint8_t b = 0; b < LAT_BUCKETS; b++) total += histogram[s][b];
+        if (!total) continue;
+
+        Serial.print(s);
+        Serial.print("     :");
+        for (uint8_t b = 0; b < LAT_BUCKETS; b++) {
+            Serial.print(' ');
+            Serial.print(histogram[s][b]);
+        }
+        Serial.print(" | ");
+        Serial.println(worstMs[s]);
+    }
+
+    Serial.print("lost ");
+    Serial.print(lostEvents);
+    Serial.print(" | slow loops ");
+    Serial.print(slowLoops);
+    Serial.print(" | worst loop ");
+    Serial.print(worstLoopMs);
+    Serial.println(" ms");
+
+    if (strcmp(args, "reset") == 0) {
+        memset(histogram, 0, sizeof(histogram));
+        memset(worstMs, 0, sizeof(worstMs));
+        lostEvents = 0;
+        slowLoops = 0;
+        worstLoopMs = 0;
+    }
+}
@@ -11,6 +11,22 @@
 
 #include <Arduino.h>
 #include "fsm.h"
+#include "ws2812b.h"
+#include "console.h"
+#include "memstats.h"
+#include "latency.h"
+#include "gesture.h"
+#include "vm.h"
+#include "flipbook.h"
+#include "snapshot.h"
+#include "clock.h"
+#include "tune.h"
+#include "trace.h"
+#include "stress.h"
+#ifdef LUMA_BENCH
+#include "noise.h"
+#include "output.h"
+#endif
 
 void pollButtons();     // Function to continously poll buttons for state change and interaction
 
@@ -21,63 +37,65 @@ LumaFSM fsm;
 const int BUTTON_A_PIN = 5;          // Connected to GPIO 5 
 const int BUTTON_B_PIN = 2;          // Connected to GPIO 2
 
-const int DEBOUNCE_TIME = 20;        // Button Debounce 20ms
-const int LONG_PRESS_TIME = 1000;    // Hold for 1s for long press
-
-unsigned long buttonA_DownTime = 0;  // tracks the time for A
-unsigned long buttonB_DownTime = 0;  // tracks the time for B
-bool buttonA_WasDown = false;        // flag for button press - A      
-bool buttonB_WasDown = false;        // flag for button press - B
+// Debounce, long press and gesture timings live in gesture.h
 
 void setup(){
   Serial.begin(115200);
+  Trace_Init();         // [env:trace] only - cycle counter rate
+  LOG("[BOOT] Luma profile: " LUMA_PROFILE);
   pinMode(BUTTON_A_PIN, INPUT_PULLUP);  // Button A 
   pinMode(BUTTON_B_PIN, INPUT_PULLUP);  // Button B
+  Latency_Init(BUTTON_A_PIN, BUTTON_B_PIN);   // GPIO edge timestamps for the latency histograms
+
+#ifdef LUMA_BENCH
+  delay(2000);          // give the USB CDC console time to attach
+  Noise_Benchmark();    // Cost centers of the effects - [env:bench] only
+  Output_Benchmark();   // output stage runs on every present, with and without dithering
+#if LUMA_FEATURE_SCRIPT
+  Vm_Benchmark();       // built-in program vs the native flood step
+#endif
+#endif
+
+  Saver_BuildWorld();   // screensaver starfield - one canvas world for the firmware, every device only moves its own view over it
+  Tune_Load();          // stored tunables (opens the NVS handle before the heap seal) and hands them to the output stage
+  Flipbook_Mount();     // maps the flipbook partition - the MMU mapping allocates, so before the heap seal
+  fsm.restoreSnapshot();  // last state, menu option and board from NVS (opens the NVS handle before the heap seal)
+#if LUMA_FEATURE_SCRIPT
+  Vm_Init();            // stored script program (opens the NVS handle before the heap seal)
+#endif
+
+  matrix.begin();       // first show() lets the LED driver allocate its buffers
+  matrix.show();        // while setup() is still allowed to use the heap
+#ifdef LUMA_STRESS
+  Stress_Run();         // random button sequences on a simulated device, worst frame per state - [env:stress] only
+#endif
+  MemStats_SealHeap();  // no allocations from the loop after this point
 }
 
 void loop(){
+  Latency_LoopBegin();  // Loop watchdog - times everything except the frame delay
   fsm.update();     // Asks FSM what to do now - This updates FSM every 20ms
   pollButtons();    // Polls Button - to check for any button presses
-  delay(20);        // 50 FPS update rate
+  if (FEATURE_CONSOLE) Console_Poll();  // Serial commands - "help" lists them, compiled out with the console
+  MemStats_Update();// Stack & heap high-water marks
+  Latency_LoopEnd(fsm.getCurrentState());
+  Clock_Delay(20);  // 50 FPS update rate - also advances the virtual clocks
 }
 
 // ==================== Button Polling ====================
 void pollButtons() {
-    
-    // === Button A logic ===
     bool buttonA_Now = digitalRead(BUTTON_A_PIN) == LOW;    // Pressed == LOW -> then o/p 1 , Released == HIGH -> then o/p 0
-    
-    if (buttonA_Now && !buttonA_WasDown) {                  // Button A just pressed
-        buttonA_DownTime = millis();                        // Start button down timer 
-        buttonA_WasDown = true;
-    } 
-    else if (!buttonA_Now && buttonA_WasDown) {                         // Button A just released
-        unsigned long press_Duration = millis() - buttonA_DownTime;     // Calculate the press duration
-        buttonA_WasDown = false;
-        
-        if (press_Duration > DEBOUNCE_TIME) {           // Ignore any press less than Debounce time(20ms) - noise
-            if (press_Duration > LONG_PRESS_TIME)  
-                fsm.onButtonAPressed(true);             // Long Press        
-            else                              
-                fsm.onButtonAPressed(false);            // Short press      
-        }
-    }
-    
-    // === Button B logic ===
-    bool buttonB_Now = digitalRead(BUTTON_B_PIN) == LOW; // Pressed == LOW -> then o/p 1 , Released == HIGH -> then o/p 0
-    
-    if (buttonB_Now && !buttonB_WasDown) {              // Button B just pressed
-        buttonB_DownTime = millis();                    // Start button down timer
-        buttonB_WasDown = true;
-    } else if (!buttonB_Now && buttonB_WasDown) {                       // Button B just released
-        unsigned long press_Duration = millis() - buttonB_DownTime;     // Calculate the press duration
-        buttonB_WasDown = false;
-        
-        if (press_Duration > DEBOUNCE_TIME) {        // Ignore any press less than Debounce time(20ms) - noise   
-            if (press_Duration > LONG_PRESS_TIME) 
-                fsm.onButtonBPressed(true);         // Long Press
-            else 
-                fsm.onButtonBPressed(false);        // Short press 
-        }
+    bool buttonB_Now = digitalRead(BUTTON_B_PIN) == LOW;
+
+    // Recognizer only waits for multi taps / chords the current state declared
+    Gesture_Update(buttonA_Now, buttonB_Now, fsm.getStateGestures(), Clock_Uptime());
+
+    Gesture gesture;
+    while (Gesture_Next(gesture)) {
+        // A repeat is recognized while the button is still down -> its press edge is long gone, time it from here
+        LatencyButton edge = gesture == GESTURE_A_REPEAT || gesture == GESTURE_B_REPEAT ? LAT_BUTTON_NONE :
+                             gesture >= GESTURE_CHORD ? LAT_BUTTON_BOTH :
+                             gesture >= GESTURE_B_TAP ? LAT_BUTTON_B : LAT_BUTTON_A;
+        fsm.onGesture(gesture, Latency_Input(edge, fsm.getCurrentState()));
     }
-}
\ No newline at end of file
+}
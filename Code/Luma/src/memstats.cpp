@@ -0,0 +1,155 @@
+/**
+ * @file memstats.cpp
+ * @author sarvesh
+ * @brief Implementation of memstats.h
+ * @version 1.0
+ * @date 2026-2-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "memstats.h"
+#include "profiles.h"
+#include "trace.h"
+
+static_assert(MEM_BUDGET_COMPOSITOR + MEM_BUDGET_PALETTE + MEM_BUDGET_ANIMATIONS + MEM_BUDGET_FSM +
+              MEM_BUDGET_MATRIX + MEM_BUDGET_CONSOLE + MEM_BUDGET_LATENCY +
+              MEM_BUDGET_GESTURE + MEM_BUDGET_OUTPUT + MEM_BUDGET_VM + MEM_BUDGET_FLIPBOOK +
+              MEM_BUDGET_SNAPSHOT + MEM_BUDGET_CLOCK + MEM_BUDGET_TUNE + MEM_BUDGET_CANVAS + MEM_BUDGET_TRACE +
+              MEM_BUDGET_STRESS <= MEM_BUDGET_TOTAL, "subsystem budgets exceed MEM_BUDGET_TOTAL");
+
+// ==================== Linker Symbols ====================
+// Section bounds from the ESP-IDF linker script -> static RAM actually used by the whole firmware
+extern "C" {
+    extern uint8_t _data_start, _data_end;  // initialized statics
+    extern uint8_t _bss_start, _bss_end;    // zero initialized statics
+}
+
+static uint32_t stackHeadroom = UINT32_MAX; // lowest free loop task stack seen (bytes)
+static uint32_t sealedHeap = 0;             // free heap when setup() finished
+static unsigned long lastSample = 0;        // sampling rate control
+
+// ==================== Heap Seal ====================
+#ifdef LUMA_MEMCHECK
+// [env:memcheck] links with --wrap=malloc/calloc/realloc, so every allocation of the firmware passes through here.
+// Only the loop task is checked - the USB & RTOS tasks allocate on their own schedule
+static TaskHandle_t loopTask = nullptr;     // set when the heap is sealed
+static volatile uint32_t lateAllocs = 0;    // allocations by the loop task after setup()
+static volatile uint32_t lateBytes = 0;     // size of the last of them
+static uint32_t reportedAllocs = 0;         // lateAllocs already warned about
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__real_calloc(size_t n, size_t size);
+extern "C" void *__real_realloc(void *ptr, size_t size);
+
+/**
+ * @brief Counts an allocation if it happens on the loop task after setup()
+ * Runs inside malloc -> only counters, printing here could allocate again
+ */
+static inline void checkAlloc(size_t size) {
+    if (loopTask && xTaskGetCurrentTaskHandle() == loopTask) {
+        lateAllocs++;
+        lateBytes = size;
+    }
+}
+
+extern "C" void *__wrap_malloc(size_t size) {
+    checkAlloc(size);
+    return __real_malloc(size);
+}
+
+extern "C" void *__wrap_calloc(size_t n, size_t size) {
+    checkAlloc(n * size);
+    return __real_calloc(n, size);
+}
+
+extern "C" void *__wrap_realloc(void *ptr, size_t size) {
+    checkAlloc(size);
+    return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Marks the end of setup() - the heap is expected to stay untouched by the loop from here on
+ *
+ */
+void MemStats_SealHeap() {
+    sealedHeap = ESP.getFreeHeap();
+#ifdef LUMA_MEMCHECK
+    loopTask = xTaskGetCurrentTaskHandle();     // setup() and loop() run on the same Arduino task
+#endif
+}
+
+// ==================== Runtime Statistics ====================
+/**
+ * @brief Samples the loop task stack high-water mark and reports new problems
+ * The RTOS keeps the high-water mark itself, so a deep call that already returned is still caught by a sample taken later
+ */
+void MemStats_Update() {
+    TRACE_SPAN("MemStats_Update");
+    if (millis() - lastSample < MEM_SAMPLE_MS) return;
+    lastSample = millis();
+
+    uint32_t headroom = uxTaskGetStackHighWaterMark(NULL);     // bytes on ESP-IDF (StackType_t is one byte)
+    if (headroom < stackHeadroom) {
+        if (headroom < MEM_STACK_WARN) {
+            LOG_PART("[MEM] loop stack low: ");
+            LOG_PART(headroom);
+            LOG(" bytes free");
+        }
+        stackHeadroom = headroom;
+    }
+
+#ifdef LUMA_MEMCHECK
+    if (lateAllocs != reportedAllocs) {
+        reportedAllocs = lateAllocs;
+        Serial.print("[MEM] allocation after setup: ");
+        Serial.print(lateBytes);
+        Serial.print(" bytes, total ");
+        Serial.println(reportedAllocs);
+    }
+#endif
+}
+
+/**
+ * @brief Prints the memory report
+ *
+ * @param args Unused console arguments
+ */
+void MemStats_Print(const char *args) {
+    (void)args;
+
+    Serial.print("flash   : ");
+    Serial.print(LUMA_PROFILE);
+    Serial.print(" profile, image ");
+    Serial.print(ESP.getSketchSize());
+    Serial.print(" bytes | free app space ");
+    Serial.println(ESP.getFreeSketchSpace());
+
+    Serial.print("static  : data ");
+    Serial.print((uint32_t)(&_data_end - &_data_start));
+    Serial.print(" + bss ");
+    Serial.print((uint32_t)(&_bss_end - &_bss_start));
+    Serial.print(" bytes | budget of the effects ");
+    Serial.println(MEM_BUDGET_TOTAL);
+
+    Serial.print("heap    : free ");
+    Serial.print(ESP.getFreeHeap());
+    Serial.print(" | min ");
+    Serial.print(ESP.getMinFreeHeap());
+    Serial.print(" | largest block ");
+    Serial.print(ESP.getMaxAllocHeap());
+    Serial.print(" | at setup ");
+    Serial.println(sealedHeap);
+
+    Serial.print("stack   : loop task min free ");
+    Serial.print(uxTaskGetStackHighWaterMark(NULL));
+    Serial.println(" bytes");
+
+#ifdef LUMA_MEMCHECK
+    Serial.print("memcheck: ");
+    Serial.print(lateAllocs);
+    Serial.println(" allocations after setup");
+#endif
+}
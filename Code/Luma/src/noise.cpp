@@ -0,0 +1,118 @@
+/**
+ * @file noise.cpp
+ * @author sarvesh
+ * @brief Implementation of noise.h
+ * @version 1.0
+ * @date 2026-2-2
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "noise.h"
+#include "easing.h"
+
+// ==================== Lookup Tables ====================
+// Ken Perlin's reference permutation - hashes a lattice corner into a pseudo random byte
+static const uint8_t PERM[256] = {
+    151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+    140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+    247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+     57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+     74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+     60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+     65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+    200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+     52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+    207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+    119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+    129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+     81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+    184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+    222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180
+};
+
+#define P(i) PERM[(uint8_t)(i)]     // uint8_t wrap makes the lattice repeat every 256 cells
+
+// ==================== Helpers ====================
+/**
+ * @brief Dot product of the corner offset with one of the 12 cube edge gradients
+ * The gradient is picked from the low 4 bits of the hash, so there is no gradient table to store
+ *
+ * @param hash Hashed lattice corner
+ * @param x,y,z Offset from the corner, 7 bit fraction (-128..127)
+ */
+static inline int16_t grad(uint8_t hash, int16_t x, int16_t y, int16_t z) {
+    uint8_t h = hash & 15;
+    int16_t u = h < 8 ? x : y;
+    int16_t v = h < 4 ? y : ((h == 12 || h == 14) ? x : z);
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+/**
+ * @brief Fixed point linear interpolation, t is 0-255
+ *
+ */
+static inline int16_t lerp(int16_t a, int16_t b, uint8_t t) {
+    return a + (((int32_t)(b - a) * t) >> 8);
+}
+
+// ==================== Noise ====================
+/**
+ * @brief Samples 3D gradient noise at (x, y, z)
+ *
+ * Every coordinate is 8.8 fixed point, so stepping a coordinate by NOISE_CELL moves one lattice cell.
+ * Cost is 14 table reads, 8 gradient dots and 7 lerps - no floats, no divides
+ *
+ * @return uint8_t Noise value 0-255 centered around 128
+ */
+uint8_t noise3D(uint16_t x, uint16_t y, uint16_t z) {
+    uint8_t X = x >> 8, Y = y >> 8, Z = z >> 8;                 // lattice cell
+    // eased position inside the cell - smoothstep removes the visible grid creases of plain linear interpolation
+    uint8_t u = ease8(EASE_IN_OUT, x & 0xFF), v = ease8(EASE_IN_OUT, y & 0xFF), w = ease8(EASE_IN_OUT, z & 0xFF);
+
+    int16_t fx = (x & 0xFF) >> 1, fy = (y & 0xFF) >> 1, fz = (z & 0xFF) >> 1;   // offset from the near corner (0..127)
+    int16_t gx = fx - 128, gy = fy - 128, gz = fz - 128;                        // offset from the far corner (-128..-1)
+
+    // hash the 8 cube corners
+    uint8_t A = P(X) + Y,     AA = P(A) + Z, AB = P(A + 1) + Z;
+    uint8_t B = P(X + 1) + Y, BA = P(B) + Z, BB = P(B + 1) + Z;
+
+    // blend the 8 corner contributions - x first, then y, then z
+    int16_t n = lerp(lerp(lerp(grad(P(AA),     fx, fy, fz), grad(P(BA),     gx, fy, fz), u),
+                          lerp(grad(P(AB),     fx, gy, fz), grad(P(BB),     gx, gy, fz), u), v),
+                     lerp(lerp(grad(P(AA + 1), fx, fy, gz), grad(P(BA + 1), gx, fy, gz), u),
+                          lerp(grad(P(AB + 1), fx, gy, gz), grad(P(BB + 1), gx, gy, gz), u), v), w);
+
+    n = 128 + n + (n >> 1);     // raw output sits roughly in -85..85 -> stretch it to fill the byte
+    return constrain(n, 0, 255);
+}
+
+#ifdef LUMA_BENCH
+/**
+ * @brief Measures how many noise samples the MCU can take per second
+ * Runs for ~1s and sums the results so the compiler cannot drop the loop
+ *
+ */
+void Noise_Benchmark() {
+    uint32_t samples = 0;
+    uint32_t sink = 0;
+    unsigned long start = micros();
+
+    while (micros() - start < 1000000UL) {
+        for (uint16_t i = 0; i < 64; i++) {     // one 8x8 frame worth of samples per batch
+            sink += noise3D(i * 40, i * 23, samples);
+        }
+        samples += 64;
+    }
+    unsigned long took = micros() - start;
+
+    Serial.print("[BENCH] noise3D: ");
+    Serial.print((uint32_t)((uint64_t)samples * 1000000UL / took));
+    Serial.print(" samples/s | frame of 64 = ");
+    Serial.print((uint32_t)((uint64_t)took * 64 / samples));
+    Serial.print(" us | sink ");
+    Serial.println(sink);
+}
+#endif
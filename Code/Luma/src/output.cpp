@@ -0,0 +1,385 @@
+/**
+ * @file output.cpp
+ * @author sarvesh
+ * @brief Implementation of output.h
+ * @version 1.0
+ * @date 2026-2-20
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "output.h"
+#include "ws2812b.h"
+#include "memstats.h"
+#include "trace.h"
+
+#define BRIGHTNESS_GAMMA 2.6f   // same curve as GAMMA_DECODE, so the brightness level is perceptual too
+
+static uint16_t lut[3][OUTPUT_LUT_SIZE];    // 8.8 fixed point drive per channel, indexed by linear >> 8
+
+static uint8_t ditherError[NUM_LEDS][3];    // fractional drive each channel still owes the LED, carried to the next frame
+
+static uint8_t brightness = OUTPUT_BRIGHTNESS;
+static uint8_t whiteBalance[3] = { 255, 255, 255 };
+static bool dirty = true;                   // settings changed -> rebuild before the next encode
+static bool dither = OUTPUT_DITHER;
+
+static const Rgb16 *lastFrame = nullptr;    // frame on the LEDs, re-shown while it has sub-LSB levels
+static bool lastFractional = false;         // last frame had channels between two 8-bit levels
+
+#define LIMIT_UNITY 256                     // limiter scale of a frame that is not limited
+
+static uint32_t frameLoad = 0;              // unlimited 8.8 drive of every channel of the last encoded frame, summed by the encode loop
+static uint16_t powerBudget = OUTPUT_POWER_MA;
+static uint16_t limit = LIMIT_UNITY;        // drive scale of the frame on the LEDs, 8.8
+static uint16_t limitTarget = LIMIT_UNITY;  // scale the last encoded frame needs, limit moves towards it on the next one
+
+static uint16_t peakDemand = 0;             // highest unlimited frame estimate since the last reset, mA
+static uint16_t deepestLimit = LIMIT_UNITY; // lowest scale used since the last reset
+static uint32_t framesShown = 0;
+static uint32_t framesLimited = 0;
+
+#ifdef LUMA_STRESS
+static bool muted = false;                  // encode only, matrix.show() is skipped
+#endif
+
+static_assert(sizeof(lut) + sizeof(ditherError) + sizeof(whiteBalance) <= MEM_BUDGET_OUTPUT, "output tables exceed MEM_BUDGET_OUTPUT");
+
+// ==================== Settings ====================
+/**
+ * @brief Sets the global brightness
+ * Only marks the LUT dirty, the tables are rebuilt once before the next frame
+ *
+ * @param level 0-255 perceptual, 255 -> full drive
+ */
+void Output_SetBrightness(uint8_t level) {
+    if (level == brightness) return;
+    brightness = level;
+    dirty = true;
+}
+
+/**
+ * @brief Sets the per channel white balance
+ *
+ * @param r Red gain 0-255
+ * @param g Green gain 0-255
+ * @param b Blue gain 0-255
+ */
+void Output_SetWhiteBalance(uint8_t r, uint8_t g, uint8_t b) {
+    whiteBalance[0] = r;
+    whiteBalance[1] = g;
+    whiteBalance[2] = b;
+    dirty = true;
+}
+
+/**
+ * @brief Turns temporal dithering on or off
+ *
+ */
+void Output_SetDither(bool enabled) {
+    dither = enabled;
+    dirty = true;       // restarts the dither pattern with the next rebuild
+}
+
+/**
+ * @brief Sets the LED current budget of the power limiter
+ * Takes effect with the next frame, the frame on the LEDs is left alone
+ *
+ * @param milliamps Estimated panel current never to exceed, 0 -> no limit
+ */
+void Output_SetPowerBudget(uint16_t milliamps) {
+    powerBudget = milliamps;
+}
+
+// ==================== Lookup Table ====================
+/**
+ * @brief Rebuilds the three channel tables from brightness, white balance and OUTPUT_GAMMA
+ * Float math is fine here, it only runs when a setting changes. The dither error accumulators are
+ * seeded with a per pixel offset too, so equal dim pixels do not all light up on the same frame
+ */
+static void Output_Rebuild() {
+    for (int i = 0; i < NUM_LEDS; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            ditherError[i][ch] = (uint8_t)(i * 167 + ch * 85);     // 167 is odd -> every pixel of the panel starts at a different phase
+        }
+    }
+
+    float level = powf(brightness / 255.0f, BRIGHTNESS_GAMMA);
+
+    for (int ch = 0; ch < 3; ch++) {
+        float gain = level * whiteBalance[ch] * 256.0f;     // 8.8 drive at full linear input
+
+        for (int k = 0; k < OUTPUT_LUT_SIZE; k++) {
+            lut[ch][k] = (uint16_t)(powf(k / 256.0f, OUTPUT_GAMMA) * gain + 0.5f);
+        }
+    }
+
+    dirty = false;
+}
+
+/**
+ * @brief Linear channel -> 8.8 drive, interpolated between the two nearest table entries
+ *
+ */
+static inline uint16_t encodeChannel(const uint16_t *table, uint16_t v) {
+    uint16_t lo = table[v >> 8];
+    uint16_t hi = table[(v >> 8) + 1];
+    return lo + (((int32_t)(hi - lo) * (v & 0xFF)) >> 8);
+}
+
+/**
+ * @brief Rounds an 8.8 drive value to the 8-bit LED level
+ *
+ */
+static inline uint8_t driveLevel(uint16_t drive) {
+    return (drive + 128) >> 8;      // table tops out at 255 * 256, so this never overflows 255
+}
+
+/**
+ * @brief Adds the error carried from the last frame, keeps the new fractional part as the next error
+ * Over N frames the LED shows the 8.8 level on average -> sub-LSB brightness is spread in time
+ *
+ */
+static inline uint8_t ditherLevel(uint16_t drive, uint8_t &error) {
+    uint16_t v = drive + error;     // table tops out at 255 * 256 so this never overflows 16 bits
+    error = v & 0xFF;
+    return v >> 8;
+}
+
+// ==================== Power Limiter ====================
+// The encode loop already reads the unlimited drive of every channel, it sums them into frameLoad on the way -
+// the estimate costs one add per channel and no pass of its own
+
+/**
+ * @brief Estimated panel current of a frame load at a drive scale, mA
+ *
+ */
+static uint32_t loadCurrent(uint32_t load, uint16_t scale) {
+    uint32_t drive = (uint64_t)load * scale * OUTPUT_MA_PER_CHANNEL / (LIMIT_UNITY * 255UL * 256UL);
+    return NUM_LEDS * OUTPUT_MA_IDLE + drive;
+}
+
+/**
+ * @brief Scale that keeps the current frame within the budget
+ *
+ */
+static uint16_t targetLimit() {
+    uint32_t demand = loadCurrent(frameLoad, LIMIT_UNITY);
+    if (demand > peakDemand) peakDemand = demand > 0xFFFF ? 0xFFFF : demand;
+
+    if (!powerBudget || demand <= powerBudget) return LIMIT_UNITY;
+
+    uint32_t idle = NUM_LEDS * OUTPUT_MA_IDLE;
+    if (powerBudget <= idle) return 0;
+    return (uint32_t)(powerBudget - idle) * LIMIT_UNITY / (demand - idle);     // < LIMIT_UNITY since demand > budget
+}
+
+/**
+ * @brief Moves the limiter scale one frame towards the target measured on the last encode
+ * Goes down in one step, comes back up with a time constant of ~16 frames so a bright flash passing by
+ * does not pump the rest of the scene
+ *
+ */
+static void stepLimit() {
+    if (limitTarget < limit)      limit = limitTarget;
+    else if (limitTarget > limit) limit += (limitTarget - limit + 15) >> 4;
+}
+
+/**
+ * @brief Applies the limiter scale to an 8.8 drive value
+ *
+ */
+static inline uint16_t limitDrive(uint16_t drive) {
+    return ((uint32_t)drive * limit) >> 8;
+}
+
+// ==================== Output Stage ====================
+/**
+ * @brief Encodes a frame into the matrix pixel buffer without showing it, at the current limiter scale
+ * Constant cost - 3 table reads, one interpolation and one add per channel, plus the add into frameLoad
+ *
+ * @return true if any channel sits between two 8-bit levels
+ */
+static bool encodeFrame(const Rgb16 *frame) {
+    uint8_t fraction = 0;
+    uint32_t load = 0;
+
+    for (int i = 0; i < NUM_LEDS; i++) {
+        uint16_t r = encodeChannel(lut[0], frame[i].r);
+        uint16_t g = encodeChannel(lut[1], frame[i].g);
+        uint16_t b = encodeChannel(lut[2], frame[i].b);
+        load += r + g + b;      // before the limiter -> what the frame asks for
+
+        if (limit < LIMIT_UNITY) {
+            r = limitDrive(r);
+            g = limitDrive(g);
+            b = limitDrive(b);
+        }
+
+        if (dither) {
+            fraction |= r | g | b;
+            matrix.setPixelColor(i, ditherLevel(r, ditherError[i][0]),
+                                    ditherLevel(g, ditherError[i][1]),
+                                    ditherLevel(b, ditherError[i][2]));
+        } else {
+            matrix.setPixelColor(i, driveLevel(r), driveLevel(g), driveLevel(b));
+        }
+    }
+    frameLoad = load;
+    return fraction != 0;   // only the low byte survives the uint8_t, so this is exactly "any fractional bits"
+}
+
+/**
+ * @brief Encodes a frame at the current limiter scale and sends it to the LEDs
+ * The encode measures the load of the frame on the way, the scale it needs is applied from the next frame on -
+ * one encode per frame, and a frame that jumps over the budget is over it for a single 20ms frame only
+ *
+ */
+static void present(const Rgb16 *frame) {
+    stepLimit();
+
+    lastFrame = frame;
+    lastFractional = encodeFrame(frame);
+    limitTarget = targetLimit();
+
+    framesShown++;
+    if (limit < LIMIT_UNITY) framesLimited++;
+    if (limit < deepestLimit) deepestLimit = limit;
+
+#ifdef LUMA_STRESS
+    if (muted) return;
+#endif
+    TRACE_SPAN("show");
+    matrix.show();
+}
+
+/**
+ * @brief Encodes a full frame into the matrix and shows it
+ * Every frame the compositor presents goes through here exactly once
+ *
+ * @param frame NUM_LEDS linear colors in pixelIndex() order
+ */
+void Output_Show(const Rgb16 *frame) {
+    TRACE_SPAN("Output_Show");
+    if (dirty) Output_Rebuild();
+
+    present(frame);
+}
+
+/**
+ * @brief Shows the last frame again so the dither keeps averaging out while nothing changes
+ * Called by the compositor when none of the layers changed - a frame of whole 8-bit levels is left alone,
+ * unless the limiter is still moving towards the scale of that frame
+ *
+ * @return true if a frame was sent to the LEDs
+ */
+bool Output_Refresh() {
+    if (!lastFrame) return false;
+    if (limit == limitTarget && (!dither || !lastFractional)) return false;
+
+    TRACE_SPAN("Output_Show");
+    if (dirty) Output_Rebuild();    // settings changed while the frame stands, the encode measures its load again
+    present(lastFrame);
+    return true;
+}
+
+#ifdef LUMA_STRESS
+/**
+ * @brief Stops sending frames to the LEDs, the encode and the limiter still run
+ * show() is ~2ms of wire time per frame that says nothing about the frame cost, a campaign would spend most of its time there
+ *
+ */
+void Output_SetMuted(bool mute) {
+    muted = mute;
+}
+#endif
+
+/**
+ * @brief Limiter and dither back to the power on state - a fresh simulated device (stress runs)
+ * The settings are kept, the tables are rebuilt and the dither pattern restarts with the next frame
+ *
+ */
+void Output_Reset() {
+    limit = LIMIT_UNITY;
+    limitTarget = LIMIT_UNITY;
+    lastFrame = nullptr;
+    lastFractional = false;
+    dirty = true;
+}
+
+/**
+ * @brief Console command "power"
+ * Prints the budget, the estimate of the frame on the LEDs with and without the limiter and how often it had to act,
+ * "power reset" clears the peak and the counters
+ *
+ */
+void Output_PowerCommand(const char *args) {
+    if (strcmp(args, "reset") == 0) {
+        peakDemand = 0;
+        deepestLimit = limit;
+        framesShown = 0;
+        framesLimited = 0;
+        Serial.println("power: counters cleared");
+        return;
+    }
+    if (*args) { Serial.println("power: status | reset"); return; }
+
+    Serial.print("budget ");
+    if (powerBudget) {
+        Serial.print(powerBudget);
+        Serial.print(" mA");
+    } else {
+        Serial.print("off");
+    }
+    Serial.print(" | frame ");
+    Serial.print(loadCurrent(frameLoad, limit));
+    Serial.print(" mA (unlimited ");
+    Serial.print(loadCurrent(frameLoad, LIMIT_UNITY));
+    Serial.print(" mA) | scale ");
+    Serial.print(limit);
+    Serial.println("/256");
+
+    Serial.print("limited ");
+    Serial.print(framesLimited);
+    Serial.print(" of ");
+    Serial.print(framesShown);
+    Serial.print(" frames | deepest scale ");
+    Serial.print(deepestLimit);
+    Serial.print("/256 | peak unlimited ");
+    Serial.print(peakDemand);
+    Serial.println(" mA");
+}
+
+#ifdef LUMA_BENCH
+/**
+ * @brief Measures the encode cost of one frame with and without dithering
+ * Times the pixel loop only, matrix.show() is bound by the LED protocol and is the same either way
+ *
+ */
+void Output_Benchmark() {
+    static Rgb16 frame[NUM_LEDS];
+    for (int i = 0; i < NUM_LEDS; i++) {
+        frame[i] = Color_HSV(i * 1024, 255, i * 4);     // dim to bright ramp -> plenty of fractional levels
+    }
+    if (dirty) Output_Rebuild();
+
+    bool wasDithering = dither;
+    for (int pass = 0; pass < 2; pass++) {
+        dither = (pass == 0);
+        uint32_t frames = 0;
+        unsigned long start = micros();
+
+        while (micros() - start < 500000UL) {
+            encodeFrame(frame);
+            frames++;
+        }
+        unsigned long took = micros() - start;
+
+        Serial.print(dither ? "[BENCH] output dithered: " : "[BENCH] output plain: ");
+        Serial.print((uint32_t)((uint64_t)took * 1000 / frames));
+        Serial.println(" ns/frame");
+    }
+    dither = wasDithering;
+}
+#endif
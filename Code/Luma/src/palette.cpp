@@ -0,0 +1,131 @@
+/**
+ * @file palette.cpp
+ * @author sarvesh
+ * @brief Implementation of palette.h
+ * @version 1.0
+ * @date 2026-2-4
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "palette.h"
+#include "ws2812b.h"
+#include "memstats.h"
+
+static uint8_t frame[NUM_LEDS];                 // indexed framebuffer -> 1 byte per pixel instead of 3
+static Rgb16 palette[PALETTE_SIZE];             // palette as the effect defined it, the level is applied on expansion
+
+static PaletteOwner owner = PALETTE_OWNER_NONE; // effect that built the current palette
+static uint8_t rotation = 0;                    // palette cycling offset
+static uint8_t level = 255;                     // palette-wide brightness
+
+static_assert(sizeof(frame) + sizeof(palette) <= MEM_BUDGET_PALETTE, "palette buffers exceed MEM_BUDGET_PALETTE");
+
+/**
+ * @brief Takes over the palette for an effect
+ * Resets the rotation and level so the new owner starts from a known state
+ *
+ * @param newOwner Effect that wants to draw with the palette
+ * @return true if the palette was built by someone else and the caller has to fill its entries
+ */
+bool Palette_Acquire(PaletteOwner newOwner) {
+    if (owner == newOwner) return false;
+
+    owner = newOwner;
+    rotation = 0;
+    level = 255;
+    return true;
+}
+
+/**
+ * @brief Sets one palette entry
+ *
+ * @param index Palette index 0-255
+ * @param color Linear light color
+ */
+void Palette_Set(uint8_t index, const Rgb16 &color) {
+    palette[index] = color;
+}
+
+/**
+ * @brief Sets the palette cycling offset - O(1), applied while expanding the frame
+ *
+ */
+void Palette_SetRotation(uint8_t offset) {
+    rotation = offset;
+}
+
+/**
+ * @brief Sets the palette-wide brightness - O(1), applied while expanding the frame
+ *
+ * @param newLevel 255 -> palette as defined, 0 -> black
+ */
+void Palette_SetLevel(uint8_t newLevel) {
+    level = newLevel;
+}
+
+/**
+ * @brief Clears the indexed framebuffer to index 0
+ *
+ */
+void Palette_Clear() {
+    memset(frame, 0, sizeof(frame));
+}
+
+/**
+ * @brief Framebuffer, owner, rotation and level as after power on - a fresh simulated device (stress runs)
+ *
+ */
+void Palette_Reset() {
+    memset(frame, 0, sizeof(frame));
+    owner = PALETTE_OWNER_NONE;     // the next effect builds its palette again
+    rotation = 0;
+    level = 255;
+}
+
+/**
+ * @brief Writes a palette index into the framebuffer
+ *
+ * @param idx Linear pixel index from pixelIndex()
+ * @param index Palette index
+ */
+void Palette_SetPixel(int idx, uint8_t index) {
+    frame[idx] = index;
+}
+
+/**
+ * @brief Reads a palette index from the framebuffer
+ *
+ */
+uint8_t Palette_GetPixel(int idx) {
+    return frame[idx];
+}
+
+/**
+ * @brief Palette entry with the level applied
+ * Linear light, so level / 256 is an exact fraction of the light output - full level is a plain read,
+ * a fade costs one scale per expanded pixel instead of a second 256 entry palette
+ */
+static inline Rgb16 leveled(uint8_t index) {
+    return (level == 255) ? palette[index] : Color_Scale(palette[index], level);
+}
+
+/**
+ * @brief Expanded color of one pixel
+ * This is the only place where indices become colors, one table read per pixel
+ *
+ * @param idx Linear pixel index
+ */
+Rgb16 Palette_GetColor(int idx) {
+    return leveled(frame[idx] + rotation);
+}
+
+/**
+ * @brief Color a palette index currently maps to (rotation applied)
+ * Lets effects draw palette colors into ordinary RGB layers
+ *
+ * @param index Palette index
+ */
+Rgb16 Palette_Lookup(uint8_t index) {
+    return leveled(index + rotation);
+}
@@ -0,0 +1,202 @@
+/**
+ * @file snapshot.cpp
+ * @author sarvesh
+ * @brief Implementation of snapshot.h
+ * @version 1.0
+ * @date 2026-2-28
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include <Preferences.h>
+#include "snapshot.h"
+#include "memstats.h"
+
+#define FLAG_FAST_BOOT  0x01    // skip the boot animation
+#define FLAG_FAST_SET   0x02    // fast boot was set from the console -> overrides LUMA_FAST_BOOT
+
+static uint8_t written[SNAPSHOT_MAX];   // blob currently in flash
+static uint8_t writtenLength = 0;       // 0 -> nothing stored
+static uint32_t writes = 0;             // lifetime write counter, kept in the blob
+static uint32_t pendingHash = 0;        // payload hash of the last offered snapshot
+static unsigned long changedAt = 0;     // when the offered snapshot last changed
+static unsigned long lastWrite = 0;
+static unsigned long lastCheck = 0;
+static bool wroteThisBoot = false;
+static uint8_t flags = 0;               // FLAG_ bits
+
+// ==================== Storage ====================
+static Preferences prefs;   // opened once from setup() - the NVS handle is allocated before the heap seal
+
+static void storeOpen() {
+    prefs.begin(SNAPSHOT_NAMESPACE, false);
+}
+
+static size_t storeRead(uint8_t *blob, size_t max) {
+    size_t length = prefs.getBytesLength(SNAPSHOT_KEY);
+    return (length && length <= max) ? prefs.getBytes(SNAPSHOT_KEY, blob, length) : 0;
+}
+
+static bool storeWrite(const uint8_t *blob, size_t length) {
+    return prefs.putBytes(SNAPSHOT_KEY, blob, length) == length;
+}
+
+static void storeClear() {
+    prefs.remove(SNAPSHOT_KEY);
+}
+
+static_assert(sizeof(written) + sizeof(writtenLength) + sizeof(writes) + sizeof(pendingHash) + sizeof(changedAt) +
+              sizeof(lastWrite) + sizeof(lastCheck) + sizeof(wroteThisBoot) + sizeof(flags) +
+              sizeof(prefs) <= MEM_BUDGET_SNAPSHOT, "snapshot statics exceed MEM_BUDGET_SNAPSHOT");
+
+// ==================== Encoding ====================
+static inline uint32_t read32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void write32(uint8_t *p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+/**
+ * @brief Builds the blob of a snapshot, the write counter is filled in when it is written
+ *
+ * @return Blob length
+ */
+static uint8_t encode(const Snapshot &snapshot, uint8_t *blob) {
+    blob[0] = SNAPSHOT_VERSION;
+    write32(blob + 1, writes);
+    blob[5] = flags;
+    blob[6] = snapshot.state;
+    blob[7] = snapshot.menuOption;
+    memcpy(blob + 8, snapshot.board, snapshot.boardLength);
+    return 8 + snapshot.boardLength;
+}
+
+/**
+ * @brief FNV-1a of the payload - cheap change detection without a second copy of the blob
+ *
+ */
+static uint32_t payloadHash(const uint8_t *blob, uint8_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = SNAPSHOT_HEADER; i < length; i++) hash = (hash ^ blob[i]) * 16777619u;
+    return hash;
+}
+
+// ==================== Snapshots ====================
+/**
+ * @brief Reads the last snapshot
+ * random() is left on the hardware RNG - nothing random is stored, so a settled device never writes
+ *
+ * @param snapshot Filled when the function returns true
+ * @return true if a valid snapshot of this version was stored
+ */
+bool Snapshot_Load(Snapshot &snapshot) {
+    storeOpen();
+
+    uint8_t blob[SNAPSHOT_MAX];
+    uint8_t length = storeRead(blob, sizeof(blob));
+
+    if (length < 8 || blob[0] != SNAPSHOT_VERSION) {
+        flags = LUMA_FAST_BOOT ? FLAG_FAST_BOOT : 0;
+        return false;
+    }
+
+    memcpy(written, blob, length);
+    writtenLength = length;
+    writes = read32(blob + 1);
+    flags = blob[5];
+    if (!(flags & FLAG_FAST_SET)) flags = LUMA_FAST_BOOT ? FLAG_FAST_BOOT : 0;
+
+    snapshot.state = blob[6];
+    snapshot.menuOption = blob[7];
+    snapshot.boardLength = length - 8;
+    memcpy(snapshot.board, blob + 8, snapshot.boardLength);
+    return true;
+}
+
+bool Snapshot_FastBoot() {
+    return flags & FLAG_FAST_BOOT;
+}
+
+bool Snapshot_Due(unsigned long now) {
+    if (now - lastCheck < SNAPSHOT_CHECK_MS) return false;
+    lastCheck = now;
+    return true;
+}
+
+/**
+ * @brief Writes the snapshot if it differs from flash, has settled and the last write is old enough
+ * NVS may allocate while it writes - at most once per SNAPSHOT_GAP_MS
+ *
+ */
+void Snapshot_Offer(const Snapshot &snapshot, unsigned long now) {
+    uint8_t blob[SNAPSHOT_MAX];
+    uint8_t length = encode(snapshot, blob);
+
+    uint32_t hash = payloadHash(blob, length);
+    if (hash != pendingHash) {      // still changing -> restart the settle time
+        pendingHash = hash;
+        changedAt = now;
+    }
+
+    if (length == writtenLength && memcmp(blob + SNAPSHOT_HEADER, written + SNAPSHOT_HEADER, length - SNAPSHOT_HEADER) == 0) return;
+    if (now - changedAt < SNAPSHOT_SETTLE_MS) return;
+    if (wroteThisBoot && now - lastWrite < SNAPSHOT_GAP_MS) return;
+
+    write32(blob + 1, writes + 1);
+    lastWrite = now;                // a failed write is not retried before the gap either
+    wroteThisBoot = true;
+    if (!storeWrite(blob, length)) return;
+
+    writes++;
+    memcpy(written, blob, length);
+    writtenLength = length;
+}
+
+// ==================== Console ====================
+/**
+ * @brief Console command "snap"
+ * "snap" prints the stored snapshot, "snap fast on|off" sets fast boot, "snap clear" forgets the snapshot
+ *
+ */
+void Snapshot_Command(const char *args) {
+    if (strncmp(args, "fast", 4) == 0) {
+        const char *value = args + 4;
+        while (*value == ' ') value++;
+        if (strcmp(value, "on") == 0)       flags |= FLAG_FAST_BOOT | FLAG_FAST_SET;
+        else if (strcmp(value, "off") == 0) flags = (flags & ~FLAG_FAST_BOOT) | FLAG_FAST_SET;
+        else { Serial.println("snap: fast on | fast off"); return; }
+
+        Serial.print("snap: fast boot ");
+        Serial.println(Snapshot_FastBoot() ? "on (stored with the next snapshot)" : "off (stored with the next snapshot)");
+        return;
+    }
+
+    if (strcmp(args, "clear") == 0) {
+        storeClear();
+        writtenLength = 0;
+        Serial.println("snap: cleared - the next boot starts fresh unless the state is saved again");
+        return;
+    }
+
+    if (writtenLength) {
+        Serial.print("snap: state ");
+        Serial.print(written[6]);
+        Serial.print(" | menu ");
+        Serial.print(written[7]);
+        Serial.print(" | board ");
+        Serial.print(writtenLength - 8);
+        Serial.print(" bytes");
+    } else {
+        Serial.print("snap: nothing stored");
+    }
+    Serial.print(" | writes ");
+    Serial.print(writes);
+    Serial.print(" | fast boot ");
+    Serial.println(Snapshot_FastBoot() ? "on" : "off");
+}
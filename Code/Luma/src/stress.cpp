@@ -0,0 +1,311 @@
+/**
+ * @file stress.cpp
+ * @author sarvesh
+ * @brief Implementation of stress.h
+ * @version 1.0
+ * @date 2026-3-13
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include <new>
+#include "stress.h"
+#include "fsm.h"
+#include "gesture.h"
+#include "clock.h"
+#include "memstats.h"
+#include "compositor.h"
+#include "palette.h"
+#include "output.h"
+#if LUMA_FEATURE_SCRIPT
+#include "vm.h"
+#endif
+
+#ifdef LUMA_STRESS
+
+struct StressRecord {       // Worst frame of one state over the campaign
+    uint32_t us;            // input handling + update + present, 0 -> state never reached
+    uint32_t seed;          // run that produced it - the sequence is generated again from it
+    uint8_t steps;          // steps of the sequence fed up to that frame
+};
+
+struct StressResult {       // Worst frame of every state in one replay
+    uint32_t us[CLOCK_COUNT];
+    uint8_t steps[CLOCK_COUNT];
+    bool reached;           // the replay hit its stop frame
+};
+
+alignas(LumaFSM) static uint8_t deviceStorage[sizeof(LumaFSM)];   // the simulated device, built again for every replay
+static StressStep sequence[STRESS_MAX_STEPS];   // sequence being run or shrunk
+static StressStep candidate[STRESS_MAX_STEPS];  // shrink candidate
+static StressRecord records[CLOCK_COUNT];       // one per LumaState
+
+static_assert(sizeof(deviceStorage) + sizeof(sequence) + sizeof(candidate) + sizeof(records) <= MEM_BUDGET_STRESS, "stress runner exceeds MEM_BUDGET_STRESS");
+
+// ==================== Sequence Generator ====================
+enum StressBurst {
+    BURST_TAP_STORM,    // rapid B taps -> every MAX_FLOODS slot in Color Flood, a cycling storm in the menu
+    BURST_HOLD_SPAM,    // B long presses -> 8-10 falling pixels each, the Falling Pixel finale after a few
+    BURST_NAVIGATE,     // A tap, cycle the menu, hold B to select -> gets the sequence into the interactions
+    BURST_MASH,         // A and B taps as fast as the recognizer takes them
+    BURST_CHORD,        // both buttons, short or held
+    BURST_RANDOM,       // any level for any time
+    BURST_IDLE,         // nothing pressed, effects run on their own
+    BURST_COUNT
+};
+
+static inline uint8_t append(StressStep *seq, uint8_t length, uint8_t buttons, uint8_t ticks) {
+    if (length < STRESS_MAX_STEPS) seq[length++] = StressStep{ buttons, ticks };
+    return length;
+}
+
+/**
+ * @brief Builds the sequence of one run from random bursts
+ * Only depends on the seed, so a record is replayed by generating its sequence again
+ *
+ * @return Steps written
+ */
+static uint8_t generate(StressStep *seq, uint32_t seed) {
+    randomSeed(seed);
+    uint8_t length = 0;
+
+    while (length < STRESS_MAX_STEPS) {
+        switch (random(BURST_COUNT)) {
+            case BURST_TAP_STORM:
+                for (int i = random(4, 12); i > 0; i--) {
+                    length = append(seq, length, STRESS_B, 2);      // 40ms press, just above the debounce
+                    length = append(seq, length, 0, 2);
+                }
+                break;
+
+            case BURST_HOLD_SPAM:
+                for (int i = random(2, 8); i > 0; i--) {
+                    length = append(seq, length, STRESS_B, random(52, 70));    // just past GESTURE_LONG_MS
+                    length = append(seq, length, 0, 2);
+                }
+                break;
+
+            case BURST_NAVIGATE:
+                length = append(seq, length, STRESS_A, 3);
+                length = append(seq, length, 0, 15);
+                for (int i = random(0, MENU_COUNT); i > 0; i--) {
+                    length = append(seq, length, STRESS_B, 3);
+                    length = append(seq, length, 0, 5);
+                }
+                length = append(seq, length, STRESS_B, 55);
+                length = append(seq, length, 0, 5);
+                break;
+
+            case BURST_MASH:
+                for (int i = random(6, 16); i > 0; i--) {
+                    length = append(seq, length, random(1, 3), 2);  // A or B
+                    length = append(seq, length, 0, random(1, 4));
+                }
+                break;
+
+            case BURST_CHORD:
+                length = append(seq, length, STRESS_A | STRESS_B, random(2, 60));
+                length = append(seq, length, 0, 3);
+                break;
+
+            case BURST_RANDOM:
+                for (int i = random(4, 12); i > 0; i--) {
+                    length = append(seq, length, random(0, 4), random(1, 40));
+                }
+                break;
+
+            default:
+                length = append(seq, length, 0, random(10, 120));
+                break;
+        }
+    }
+    return length;
+}
+
+// ==================== Simulated Device ====================
+/**
+ * @brief One frame of the simulated device - same order as loop(), timed from the input to the shown frame
+ *
+ * @return Time of input handling + update + present in us
+ */
+static uint32_t frame(LumaFSM &device, uint8_t buttons) {
+    uint32_t start = micros();
+
+    Gesture_Update(buttons & STRESS_A, buttons & STRESS_B, device.getStateGestures(), Clock_Uptime());
+    Gesture gesture;
+    while (Gesture_Next(gesture)) device.onGesture(gesture);
+    device.update();
+
+    uint32_t took = micros() - start;
+    Clock_Skip(STRESS_FRAME_MS);    // frames run back to back, the frame delay only passes on the clocks
+    return took;
+}
+
+/**
+ * @brief Feeds a sequence to a freshly booted device and keeps the worst frame of every state
+ * The device boots with no buttons pressed, then gets the sequence, then idles so the last input plays out.
+ * Everything a power cycle would clear is cleared first (clock, gestures, layers, palette, limiter, script) and the
+ * random generator is seeded the same way every time, so a replay does not depend on the ones before it
+ *
+ * @param stopState State to watch while shrinking, CLOCK_COUNT -> run to the end
+ * @param stopUs A frame of stopState taking at least this long ends the replay (result.reached)
+ */
+static void replay(const StressStep *seq, uint8_t length, uint32_t seed, StressResult &result, uint8_t stopState, uint32_t stopUs) {
+    memset(&result, 0, sizeof(result));
+    vTaskDelay(1);          // a replay holds the CPU for a while, let the idle task feed the watchdog in between
+
+    Clock_Reset();
+    Gesture_Reset();
+    Compositor_Reset();     // also drops the menu previews and the settled sand kept across states
+    Palette_Reset();
+    Output_Reset();
+#if LUMA_FEATURE_SCRIPT
+    Vm_Start();
+#endif
+    randomSeed(seed);
+    LumaFSM *device = new (deviceStorage) LumaFSM();
+
+    for (int step = -1; step <= length && !result.reached; step++) {
+        uint8_t buttons = (step >= 0 && step < length) ? seq[step].buttons : 0;
+        uint16_t ticks = step < 0 ? STRESS_BOOT_TICKS : step < length ? seq[step].ticks : STRESS_TAIL_TICKS;
+        uint8_t fed = step < 0 ? 0 : step < length ? step + 1 : length;
+
+        for (uint16_t t = 0; t < ticks; t++) {
+            uint8_t state = device->getCurrentState();
+            uint32_t took = frame(*device, buttons);
+
+            if (took > result.us[state]) {
+                result.us[state] = took;
+                result.steps[state] = fed;
+            }
+            if (state == stopState && took >= stopUs) {
+                result.reached = true;
+                break;
+            }
+        }
+    }
+
+    device->~LumaFSM();     // gives back crossfade frames still in use
+}
+
+// ==================== Shrinking ====================
+/**
+ * @brief Shrinks sequence[] to a shorter one whose worst frame in the state is still at least threshold
+ * Removes chunks of steps, halving the chunk size down to single steps, then halves the hold time of each step
+ * that is left - every candidate is a full replay, bounded by what is left of STRESS_REPLAY_MAX
+ *
+ * @param replays Replays of the campaign so far, counted up
+ * @return Steps left in sequence[]
+ */
+static uint8_t shrink(uint8_t length, uint32_t seed, uint8_t state, uint32_t threshold, uint16_t &replays) {
+    StressResult result;
+
+    for (uint8_t chunk = length > 1 ? length / 2 : length; chunk >= 1; chunk /= 2) {
+        for (uint8_t start = 0; start + chunk <= length && replays < STRESS_REPLAY_MAX; ) {
+            uint8_t kept = 0;
+            for (uint8_t i = 0; i < length; i++) {
+                if (i < start || i >= start + chunk) candidate[kept++] = sequence[i];
+            }
+
+            replay(candidate, kept, seed, result, state, threshold);
+            replays++;
+            if (result.reached) {       // chunk not needed -> the next chunk moved up to start
+                memcpy(sequence, candidate, kept * sizeof(StressStep));
+                length = kept;
+            } else {
+                start += chunk;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < length; i++) {
+        while (sequence[i].ticks > 1 && replays < STRESS_REPLAY_MAX) {
+            memcpy(candidate, sequence, length * sizeof(StressStep));
+            candidate[i].ticks /= 2;
+
+            replay(candidate, length, seed, result, state, threshold);
+            replays++;
+            if (!result.reached) break;
+            sequence[i].ticks = candidate[i].ticks;
+        }
+    }
+    return length;
+}
+
+// ==================== Campaign ====================
+static void printSequence(const StressStep *seq, uint8_t length) {
+    for (uint8_t i = 0; i < length; i++) {
+        Serial.print(i ? " " : "  ");
+        if (seq[i].buttons & STRESS_A) Serial.print('A');
+        if (seq[i].buttons & STRESS_B) Serial.print('B');
+        if (!seq[i].buttons)           Serial.print('_');
+        Serial.print(seq[i].ticks);
+    }
+    Serial.println(length ? "" : "  (no input - boot and idle frames)");
+}
+
+/**
+ * @brief Runs STRESS_RUNS random sequences, then shrinks the worst frame of every state to a minimal reproducer
+ * Prints per state : worst frame, the run it came from and the shrunk sequence (A / B / AB held, _ released,
+ * followed by the frames it lasts). The device is booted before every sequence, so each line replays on its own
+ *
+ */
+void Stress_Run() {
+    memset(records, 0, sizeof(records));
+    Output_SetMuted(true);
+    uint16_t replays = STRESS_RUNS;
+    Serial.print("[STRESS] ");
+    Serial.print(STRESS_RUNS);
+    Serial.print(" runs from seed ");
+    Serial.println(STRESS_SEED);
+
+    for (uint32_t run = 0; run < STRESS_RUNS; run++) {
+        uint32_t seed = STRESS_SEED + run;
+        uint8_t length = generate(sequence, seed);
+
+        StressResult result;
+        replay(sequence, length, seed, result, CLOCK_COUNT, 0);
+
+        for (uint8_t s = 0; s < CLOCK_COUNT; s++) {
+            if (result.us[s] > records[s].us) records[s] = StressRecord{ result.us[s], seed, result.steps[s] };
+        }
+    }
+
+    for (uint8_t s = 0; s < CLOCK_COUNT; s++) {
+        if (!records[s].us) continue;
+
+        generate(sequence, records[s].seed);
+        uint16_t before = replays;
+        uint32_t threshold = (uint64_t)records[s].us * STRESS_REPRO_PCT / 100;
+        uint8_t length = shrink(records[s].steps, records[s].seed, s, threshold, replays);
+
+        Serial.print("state ");
+        Serial.print(s);
+        Serial.print(" : worst ");
+        Serial.print(records[s].us);
+        Serial.print(" us | seed ");
+        Serial.print(records[s].seed);
+        Serial.print(", ");
+        Serial.print(records[s].steps);
+        Serial.print(" steps -> ");
+        Serial.print(length);
+        Serial.print(" steps in ");
+        Serial.print(replays - before);
+        Serial.println(" replays");
+        printSequence(sequence, length);
+    }
+
+    Output_SetMuted(false);
+    Clock_Reset();      // the real device starts from a fresh boot
+    Gesture_Reset();
+    Compositor_Reset();
+    Palette_Reset();
+    Output_Reset();
+#if LUMA_FEATURE_SCRIPT
+    Vm_Start();
+#endif
+    Serial.println("[STRESS] done");
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file timeline.cpp
+ * @author sarvesh
+ * @brief Implementation of timeline.h
+ * @version 1.0
+ * @date 2026-2-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "timeline.h"
+
+/**
+ * @brief Moves a cursor onto the segment ending at keyframe seg and caches its progress rate
+ *
+ */
+static void Timeline_EnterSegment(TrackCursor &cursor, const Track &track, uint8_t seg) {
+    cursor.segment = seg;
+
+    uint16_t span = track.keys[seg].timeMs - track.keys[seg - 1].timeMs;
+    cursor.rate = TIMELINE_RATE_END / (span ? span : 1);    // progress per ms in 16.16, zero length segments jump straight to the end
+}
+
+/**
+ * @brief Resets the player to the start of a timeline
+ *
+ * @param player Player state, usually a static of the effect
+ * @param timeline Choreography to play
+ */
+void Timeline_Start(TimelinePlayer &player, const Timeline &timeline) {
+    player.timeline = &timeline;
+    player.duration = 0;
+    player.running = true;
+
+    for (uint8_t i = 0; i < timeline.trackCount && i < TIMELINE_MAX_TRACKS; i++) {
+        const Track &track = timeline.tracks[i];
+
+        player.values[i] = track.keys[0].value;
+        player.cursors[i].segment = 0;
+        if (track.count > 1) Timeline_EnterSegment(player.cursors[i], track, 1);
+
+        uint16_t end = track.keys[track.count - 1].timeMs;
+        if (end > player.duration) player.duration = end;
+    }
+}
+
+/**
+ * @brief Evaluates every track of the timeline
+ *
+ * Cursors only move forward, so each tick is a short table walk: skip finished segments,
+ * scale the time into the segment by the cached rate, look up the easing curve and lerp
+ *
+ * @param player Player started with Timeline_Start
+ * @param elapsedMs Time since the timeline started, must not go backwards
+ * @return true while the timeline is still playing
+ */
+bool Timeline_Tick(TimelinePlayer &player, unsigned long elapsedMs) {
+    if (!player.timeline) return false;
+
+    const Timeline &timeline = *player.timeline;
+
+    for (uint8_t i = 0; i < timeline.trackCount && i < TIMELINE_MAX_TRACKS; i++) {
+        const Track &track = timeline.tracks[i];
+        TrackCursor &cursor = player.cursors[i];
+
+        if (cursor.segment == 0) continue;  // single keyframe track -> constant
+
+        // skip the segments that ended before now
+        while (cursor.segment < track.count - 1 && elapsedMs >= track.keys[cursor.segment].timeMs) {
+            Timeline_EnterSegment(cursor, track, cursor.segment + 1);
+        }
+
+        const Keyframe &from = track.keys[cursor.segment - 1];
+        const Keyframe &to   = track.keys[cursor.segment];
+
+        if (elapsedMs >= to.timeMs) {       // past the last keyframe -> hold it
+            player.values[i] = to.value;
+            continue;
+        }
+        if (elapsedMs <= from.timeMs) {     // before the segment started
+            player.values[i] = from.value;
+            continue;
+        }
+
+        uint32_t progress = ((elapsedMs - from.timeMs) * cursor.rate) >> 16;   // 0-255 through the segment, < TIMELINE_RATE_END before the >> 16
+
+        uint8_t eased = ease8(to.ease, progress);
+        player.values[i] = from.value + (((int32_t)(to.value - from.value) * eased) >> 8);
+    }
+
+    player.running = elapsedMs < player.duration;
+    return player.running;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file trace.cpp
+ * @author sarvesh
+ * @brief Implementation of trace.h
+ * @version 1.0
+ * @date 2026-3-9
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include "trace.h"
+#include "memstats.h"
+
+#ifdef LUMA_TRACE
+
+struct TraceEntry {
+    const char *name;       // TRACE_SPAN literal
+    uint32_t start;         // Trace_Now() ticks, wraps - only differences are used
+    uint32_t duration;      // ticks
+};
+
+static TraceEntry ring[TRACE_CAPACITY];
+static uint32_t head = 0;               // spans recorded so far, ring[head % TRACE_CAPACITY] is written next
+static uint16_t ticksPerUs = 1;         // Trace_Now() rate
+static bool dumping = false;            // the dump does not trace itself
+
+static_assert(sizeof(ring) + sizeof(head) + sizeof(ticksPerUs) + sizeof(dumping) <= MEM_BUDGET_TRACE, "trace ring exceeds MEM_BUDGET_TRACE");
+
+// ==================== Recording ====================
+uint32_t Trace_Now() {
+    return ESP.getCycleCount();         // mcycle, one read - 160 ticks per us at 160 MHz
+}
+
+/**
+ * @brief Adds a finished span - single writer (the loop task), no locks
+ * The entry is complete before head moves, so a reader that takes head first only sees finished entries
+ *
+ */
+void Trace_Record(const char *name, uint32_t start, uint32_t end) {
+    if (dumping) return;
+
+    TraceEntry &entry = ring[head & (TRACE_CAPACITY - 1)];
+    entry.name = name;
+    entry.start = start;
+    entry.duration = end - start;
+    __atomic_store_n(&head, head + 1, __ATOMIC_RELEASE);
+}
+
+// ==================== Chrome Trace Export ====================
+/**
+ * @brief Ticks as microseconds with 3 decimals - the unit of Chrome trace-event timestamps
+ *
+ */
+static void formatUs(char *text, size_t size, uint32_t ticks) {
+    uint32_t whole = ticks / ticksPerUs;
+    uint32_t thousandths = (uint64_t)(ticks % ticksPerUs) * 1000 / ticksPerUs;
+    snprintf(text, size, "%lu.%03lu", (unsigned long)whole, (unsigned long)thousandths);
+}
+
+/**
+ * @brief Writes the ring as a trace-event JSON document, oldest span first
+ * Every span is a complete ("X") event on one track, nesting shows from the times alone.
+ * Timestamps start at the oldest span, so the cycle counter wrapping (~27 s at 160 MHz) only matters if the ring covers longer
+ *
+ * @return Spans written
+ */
+static uint32_t dump() {
+    dumping = true;
+
+    uint32_t end = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    uint32_t first = end > TRACE_CAPACITY ? end - TRACE_CAPACITY : 0;
+    uint32_t origin = ring[first & (TRACE_CAPACITY - 1)].start;
+
+    Serial.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (uint32_t i = first; i < end; i++) {
+        const TraceEntry &entry = ring[i & (TRACE_CAPACITY - 1)];
+        char ts[16], dur[16], line[112];
+        formatUs(ts, sizeof(ts), entry.start - origin);
+        formatUs(dur, sizeof(dur), entry.duration);
+        snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%s,\"dur\":%s}%s\n",
+                 entry.name, ts, dur, i + 1 < end ? "," : "");
+        Serial.print(line);
+    }
+    Serial.print("]}\n");
+
+    dumping = false;
+    return end - first;
+}
+
+// ==================== Setup & Console ====================
+void Trace_Init() {
+    ticksPerUs = getCpuFrequencyMhz();
+}
+
+/**
+ * @brief Console command "trace"
+ * "trace" dumps the ring as JSON on the monitor between the BEGIN / END lines, "trace clear" empties it
+ *
+ */
+void Trace_Command(const char *args) {
+    if (strcmp(args, "clear") == 0) {
+        __atomic_store_n(&head, 0, __ATOMIC_RELEASE);
+        Serial.println("trace: cleared");
+        return;
+    }
+    if (*args) { Serial.println("trace: dump | clear"); return; }
+
+    Serial.println("----- BEGIN TRACE (save as trace.json, open in ui.perfetto.dev) -----");
+    uint32_t spans = dump();
+    Serial.println("----- END TRACE -----");
+    Serial.print("trace: ");
+    Serial.print(spans);
+    Serial.println(" spans");
+}
+
+#endif
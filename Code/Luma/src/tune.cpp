@@ -0,0 +1,183 @@
+/**
+ * @file tune.cpp
+ * @author sarvesh
+ * @brief Implementation of tune.h
+ * @version 1.0
+ * @date 2026-3-6
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include <Preferences.h>
+#include "tune.h"
+#include "output.h"
+#include "compositor.h"
+#include "profiles.h"
+#include "memstats.h"
+
+// ==================== Values ====================
+#define TUNE_DEFINE(name, type, def, min, max, apply, help) type tune_##name = def;
+TUNABLES(TUNE_DEFINE)
+#undef TUNE_DEFINE
+
+static Preferences prefs;       // opened once from Tune_Load() - the NVS handle is allocated before the heap seal
+static bool stored = false;     // prefs opened, false -> NVS not available
+
+#define TUNE_SIZE(name, type, def, min, max, apply, help) + sizeof(tune_##name)
+static_assert(0 TUNABLES(TUNE_SIZE) + sizeof(prefs) + sizeof(stored) <= MEM_BUDGET_TUNE, "tunables exceed MEM_BUDGET_TUNE");
+#undef TUNE_SIZE
+
+#define TUNE_CHECK(name, type, def, min, max, apply, help) \
+    static_assert(sizeof(#name) <= 16, "tunable name " #name " is longer than an NVS key"); \
+    static_assert((def) >= (min) && (def) <= (max), "default of " #name " is outside its range"); \
+    static_assert(sizeof(type) <= 2 && (max) <= (1UL << (8 * sizeof(type))) - 1, "range of " #name " does not fit its type");
+TUNABLES(TUNE_CHECK)
+#undef TUNE_CHECK
+
+// ==================== Registry ====================
+struct Tunable {
+    const char *name;
+    void *value;            // tune_<name>
+    uint8_t size;           // 1 -> uint8_t, 2 -> uint16_t
+    uint16_t def, min, max;
+    void (*apply)();        // runs after the value changed, may be nullptr
+    const char *help;
+};
+
+#define TUNE_ENTRY(name, type, def, min, max, apply, help) { #name, &tune_##name, sizeof(type), def, min, max, apply, help },
+static const Tunable TUNABLE_TABLE[] = {
+    TUNABLES(TUNE_ENTRY)
+};
+#undef TUNE_ENTRY
+
+#define TUNABLE_COUNT (sizeof(TUNABLE_TABLE) / sizeof(TUNABLE_TABLE[0]))
+
+static uint16_t getValue(const Tunable &t) {
+    return t.size == 1 ? *(uint8_t *)t.value : *(uint16_t *)t.value;
+}
+
+static void setValue(const Tunable &t, uint16_t value) {
+    if (t.size == 1) *(uint8_t *)t.value = value;
+    else             *(uint16_t *)t.value = value;
+}
+
+static const Tunable *findTunable(const char *name, size_t length) {
+    for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+        if (strlen(TUNABLE_TABLE[i].name) == length && strncmp(TUNABLE_TABLE[i].name, name, length) == 0) return &TUNABLE_TABLE[i];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Runs every apply hook once - each hook takes all of its tunables, so a hook shared by several runs more than once
+ *
+ */
+static void applyAll() {
+    for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+        if (TUNABLE_TABLE[i].apply) TUNABLE_TABLE[i].apply();
+    }
+}
+
+// ==================== Apply Hooks ====================
+void Tune_ApplyOutput() {
+    Output_SetBrightness(TUNE(brightness));
+    Output_SetWhiteBalance(TUNE(wb_red), TUNE(wb_green), TUNE(wb_blue));
+    Output_SetDither(TUNE(dither));
+    Output_SetPowerBudget(TUNE(power_ma));
+}
+
+void Tune_ApplyLayers() {
+#if LUMA_FEATURE_COLOR_FLOOD
+    Layer_SetPersistence(LAYER_FLOOD, TUNE(flood_fade));
+#endif
+#if LUMA_FEATURE_FALLING_PIXEL
+    Layer_SetPersistence(LAYER_FALL_TRAIL, TUNE(trail_fade));
+#endif
+}
+
+// ==================== Storage ====================
+/**
+ * @brief Opens the tunables namespace and reads the stored values - values outside the range of this build keep their default
+ * The handle stays open for "set save" / "set defaults", so the console never opens NVS after the heap seal
+ *
+ */
+void Tune_Load() {
+    stored = prefs.begin(TUNE_NAMESPACE, false);
+    if (stored) {
+        for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+            const Tunable &t = TUNABLE_TABLE[i];
+            uint16_t value = t.size == 1 ? prefs.getUChar(t.name, t.def) : prefs.getUShort(t.name, t.def);
+            if (value >= t.min && value <= t.max) setValue(t, value);
+        }
+    }
+    applyAll();
+}
+
+// ==================== Console ====================
+static void printTunable(const Tunable &t) {
+    Serial.print(t.name);
+    Serial.print(" = ");
+    Serial.print(getValue(t));
+    Serial.print(" (");
+    Serial.print(t.min);
+    Serial.print(" - ");
+    Serial.print(t.max);
+    Serial.print(", default ");
+    Serial.print(t.def);
+    Serial.print(") ");
+    Serial.println(t.help);
+}
+
+/**
+ * @brief Console command "set"
+ * "set" lists every tunable, "set <name> <value>" changes one, "set save" keeps the current values in NVS,
+ * "set defaults" goes back to the built-in values and forgets the stored ones
+ *
+ */
+void Tune_Command(const char *args) {
+    if (!*args) {
+        for (uint8_t i = 0; i < TUNABLE_COUNT; i++) printTunable(TUNABLE_TABLE[i]);
+        return;
+    }
+
+    if (strcmp(args, "save") == 0 || strcmp(args, "defaults") == 0) {
+        bool save = args[0] == 's';
+        if (!stored) { Serial.println("set: NVS not available"); return; }
+
+        for (uint8_t i = 0; i < TUNABLE_COUNT; i++) {
+            const Tunable &t = TUNABLE_TABLE[i];
+            if (!save)            setValue(t, t.def);
+            else if (t.size == 1) prefs.putUChar(t.name, getValue(t));
+            else                  prefs.putUShort(t.name, getValue(t));
+        }
+        if (!save) prefs.clear();
+
+        if (!save) applyAll();
+        Serial.println(save ? "set: saved, used from the next boot on" : "set: defaults restored");
+        return;
+    }
+
+    const char *value = strchr(args, ' ');
+    const Tunable *t = findTunable(args, value ? (size_t)(value - args) : strlen(args));
+    if (!t) { Serial.println("set: unknown tunable - 'set' lists them"); return; }
+
+    if (!value) { printTunable(*t); return; }
+
+    while (*value == ' ') value++;
+    char *end;
+    long number = strtol(value, &end, 10);
+    if (end == value || *end || number < t->min || number > t->max) {
+        Serial.print("set: ");
+        Serial.print(t->name);
+        Serial.print(" takes ");
+        Serial.print(t->min);
+        Serial.print(" - ");
+        Serial.println(t->max);
+        return;
+    }
+
+    setValue(*t, number);
+    if (t->apply) t->apply();
+    printTunable(*t);
+}
@@ -0,0 +1,528 @@
+/**
+ * @file vm.cpp
+ * @author sarvesh
+ * @brief Implementation of vm.h
+ * @version 1.0
+ * @date 2026-2-24
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <Arduino.h>
+#include <Preferences.h>
+#include "vm.h"
+#include "ws2812b.h"
+#include "color.h"
+#include "compositor.h"
+#include "memstats.h"
+#include "profiles.h"
+#include "clock.h"
+#include "trace.h"
+#ifdef LUMA_BENCH
+#include "animations.h"
+#endif
+
+#if LUMA_FEATURE_SCRIPT
+// ==================== Built-in Program ====================
+// scripts/vm/flood.lasm assembled with scripts/vm_asm.py --c-array - runs until a program is uploaded
+static const uint8_t BUILTIN[] = {
+    0x4C, 0x56, 0x01, 0x37, 0x02, 0xE6, 0x00, 0x25, 0x21, 0x01, 0x01, 0x11,
+    0x1B, 0x13, 0x00, 0x03, 0x03, 0x02, 0xE0, 0x2E, 0x09, 0x04, 0x03, 0x03,
+    0x02, 0x1C, 0x22, 0x00, 0x01, 0x08, 0x1E, 0x04, 0x00, 0x01, 0x08, 0x1E,
+    0x04, 0x01, 0x01, 0x00, 0x04, 0x04, 0x03, 0x03, 0x03, 0x04, 0x02, 0xC8,
+    0x00, 0x0B, 0x09, 0x02, 0xFF, 0x00, 0x01, 0x5A, 0x22, 0x03, 0x00, 0x03,
+    0x01, 0x03, 0x04, 0x27, 0x03, 0x04, 0x01, 0x01, 0x09, 0x05, 0x04, 0x04,
+    0x03, 0x02, 0x17, 0x1B, 0x26, 0x00, 0x03, 0x02, 0x01, 0x01, 0x09, 0x05,
+    0x04, 0x02, 0x01, 0x10, 0x17, 0x1B, 0x64, 0x00, 0x01, 0x00, 0x04, 0x02,
+    0x03, 0x03, 0x02, 0xA0, 0x0F, 0x09, 0x04, 0x03, 0x00,
+};
+
+// ==================== Instruction Table ====================
+struct VmOpInfo {
+    uint8_t size;       // bytes including the immediate
+    uint8_t pops;       // stack values consumed
+    uint8_t pushes;     // stack values produced
+};
+
+static const VmOpInfo OP_INFO[VM_OP_COUNT] = {     // same order as VmOp
+    { 1, 0, 0 }, { 2, 0, 1 }, { 3, 0, 1 }, { 2, 0, 1 }, { 2, 1, 0 },    // halt push8 push16 load store
+    { 1, 1, 2 }, { 1, 1, 0 }, { 1, 2, 2 }, { 1, 2, 3 },                 // dup drop swap over
+    { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 },    // add sub mul div mod
+    { 1, 2, 1 }, { 1, 1, 1 }, { 1, 1, 1 },                              // mulfx neg abs
+    { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 },    // and or xor shl shr
+    { 1, 2, 1 }, { 1, 2, 1 }, { 1, 2, 1 }, { 1, 1, 1 },                 // lt gt eq not
+    { 3, 0, 0 }, { 3, 1, 0 }, { 3, 1, 0 },                              // jmp jz jnz
+    { 1, 1, 1 }, { 1, 1, 1 }, { 1, 0, 1 }, { 1, 0, 1 }, { 1, 0, 1 },    // sin rand time frame btn
+    { 1, 3, 0 }, { 1, 3, 0 }, { 1, 2, 0 }, { 1, 1, 0 }, { 1, 0, 0 },    // hsv rgb set fade clear
+    { 1, 3, 0 }, { 1, 4, 0 },                                           // ring line
+};
+
+// ==================== Interpreter State ====================
+static uint8_t program[VM_PROGRAM_MAX];     // header + code of the loaded program
+static uint16_t programLength = 0;          // 0 -> nothing runnable (upload in progress)
+static int32_t stack[VM_STACK];
+static int32_t regs[VM_REGS];               // survive between frames, cleared by Vm_Start
+
+static Rgb16 pen = RGB16_BLACK;             // color of the drawing primitives
+static uint8_t pendingButtons = 0;          // VmButton bits queued since the last frame
+static uint8_t frameButtons = 0;            // bits VM_BTN returns during this frame
+static ClockMs startTime = 0;               // program clock origin
+static ClockMs lastFrame = 0;               // period control
+static uint32_t frames = 0;
+
+static uint16_t lastMicros = 0;             // cost of the last frame
+static uint16_t worstMicros = 0;            // worst frame since the program was loaded
+static uint16_t overruns = 0;               // frames cut short by VM_STEP_LIMIT
+
+static Preferences prefs;                   // opened by Vm_Init() from setup() - the NVS handle is allocated before the heap seal
+static bool stored = false;                 // prefs opened, false -> the program is not kept across power cycles
+
+static_assert(sizeof(program) + sizeof(stack) + sizeof(regs) + sizeof(pen) + sizeof(prefs) + 32 <= MEM_BUDGET_VM, "vm state exceeds MEM_BUDGET_VM");
+static_assert(sizeof(OP_INFO) / sizeof(OP_INFO[0]) == VM_OP_COUNT, "OP_INFO must describe every opcode");
+
+#define PERIOD_MS   (program[3])                // header byte 3
+#define CODE        (program + VM_HEADER)
+
+// ==================== Verifier ====================
+#define DEPTH_NONE      -2      // byte is not the start of an instruction
+#define DEPTH_UNREACHED -1      // instruction start no path has reached yet
+
+/**
+ * @brief Checks a program once so the interpreter can trust it
+ *
+ * Every instruction must be complete and known, register operands in range, jump targets on
+ * instruction starts, no path may fall off the end, and every instruction must see the same stack
+ * depth on every path with enough values below it and no overflow above it.
+ * Stack depth is propagated until nothing changes - bounded, each pass settles at least one more
+ * instruction
+ *
+ * @return nullptr if the program is valid, else what is wrong with it
+ */
+static const char *Vm_Verify(const uint8_t *image, uint16_t length) {
+    if (length < VM_HEADER + 1 || length > VM_PROGRAM_MAX) return "bad length";
+    if (image[0] != VM_MAGIC0 || image[1] != VM_MAGIC1) return "bad magic";
+    if (image[2] != VM_VERSION) return "bad version";
+
+    const uint8_t *code = image + VM_HEADER;
+    uint16_t codeLength = length - VM_HEADER;
+
+    int8_t depth[VM_PROGRAM_MAX - VM_HEADER];   // stack depth before each instruction
+    memset(depth, DEPTH_NONE, sizeof(depth));
+
+    for (uint16_t pc = 0; pc < codeLength; ) {  // pass 1 - decode
+        uint8_t op = code[pc];
+        if (op >= VM_OP_COUNT) return "bad opcode";
+        if (pc + OP_INFO[op].size > codeLength) return "truncated instruction";
+        if ((op == VM_LOAD || op == VM_STORE) && code[pc + 1] >= VM_REGS) return "bad register";
+
+        depth[pc] = DEPTH_UNREACHED;
+        pc += OP_INFO[op].size;
+    }
+
+    for (uint16_t pc = 0; pc < codeLength; pc += OP_INFO[code[pc]].size) {   // jump targets
+        uint8_t op = code[pc];
+        if (op == VM_JMP || op == VM_JZ || op == VM_JNZ) {
+            uint16_t target = code[pc + 1] | (code[pc + 2] << 8);
+            if (target >= codeLength || depth[target] == DEPTH_NONE) return "bad jump target";
+        }
+    }
+
+    depth[0] = 0;
+    for (bool changed = true; changed; ) {      // pass 2 - stack depth
+        changed = false;
+
+        for (uint16_t pc = 0; pc < codeLength; pc += OP_INFO[code[pc]].size) {
+            if (depth[pc] == DEPTH_UNREACHED) continue;
+
+            uint8_t op = code[pc];
+            const VmOpInfo &info = OP_INFO[op];
+            if (depth[pc] < info.pops) return "stack underflow";
+
+            int8_t after = depth[pc] - info.pops + info.pushes;
+            if (after > VM_STACK) return "stack overflow";
+
+            uint16_t next = pc + info.size;
+            bool fallsThrough = (op != VM_HALT && op != VM_JMP);
+            bool jumps = (op == VM_JMP || op == VM_JZ || op == VM_JNZ);
+
+            if (fallsThrough) {
+                if (next >= codeLength) return "falls off the end";
+                if (depth[next] == DEPTH_UNREACHED) { depth[next] = after; changed = true; }
+                else if (depth[next] != after) return "stack depth mismatch";
+            }
+            if (jumps) {
+                uint16_t target = code[pc + 1] | (code[pc + 2] << 8);
+                if (depth[target] == DEPTH_UNREACHED) { depth[target] = after; changed = true; }
+                else if (depth[target] != after) return "stack depth mismatch";
+            }
+        }
+    }
+    return nullptr;
+}
+
+// ==================== Primitives ====================
+/**
+ * @brief Draws one pixel in the pen color, anything outside the matrix is clipped
+ *
+ */
+static inline void plot(int32_t x, int32_t y) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+    Layer_SetPixel(LAYER_SCRIPT, pixelIndex(y, x), pen);
+}
+
+/**
+ * @brief Clamps a line end point just outside the matrix so a line never takes more than a few dozen steps
+ *
+ */
+static inline int32_t clampCoord(int32_t v) {
+    return v < -WIDTH ? -WIDTH : (v > 2 * WIDTH ? 2 * WIDTH : v);
+}
+
+/**
+ * @brief Bresenham line in the pen color
+ *
+ */
+static void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    x0 = clampCoord(x0); y0 = clampCoord(y0);
+    x1 = clampCoord(x1); y1 = clampCoord(y1);
+
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+
+    while (true) {
+        plot(x0, y0);
+        if (x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+/**
+ * @brief Pixels at manhattan distance r from (cx, cy) - the color flood ring
+ *
+ */
+static void drawRing(int32_t cx, int32_t cy, int32_t r) {
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            if (abs(x - cx) + abs(y - cy) == r) plot(x, y);
+        }
+    }
+}
+
+static inline uint8_t clamp8(int32_t v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// ==================== Interpreter ====================
+/**
+ * @brief Runs the loaded program once from the start
+ *
+ * Direct threaded dispatch - every handler jumps straight to the handler of the next opcode through
+ * a table of label addresses (GCC computed goto), no switch and no bounds checks because the program
+ * was verified when it was loaded. Arithmetic wraps like the hardware does (done in uint32_t).
+ * Only backward jumps count against VM_STEP_LIMIT - straight line code always ends
+ */
+static void Vm_Execute() {
+    static const void *const DISPATCH[VM_OP_COUNT] = {     // same order as VmOp
+        &&op_halt, &&op_push8, &&op_push16, &&op_load, &&op_store,
+        &&op_dup, &&op_drop, &&op_swap, &&op_over,
+        &&op_add, &&op_sub, &&op_mul, &&op_div, &&op_mod, &&op_mulfx, &&op_neg, &&op_abs,
+        &&op_and, &&op_or, &&op_xor, &&op_shl, &&op_shr,
+        &&op_lt, &&op_gt, &&op_eq, &&op_not,
+        &&op_jmp, &&op_jz, &&op_jnz,
+        &&op_sin, &&op_rand, &&op_time, &&op_frame, &&op_btn,
+        &&op_hsv, &&op_rgb, &&op_set, &&op_fade, &&op_clear, &&op_ring, &&op_line,
+    };
+
+    const uint8_t *code = CODE;
+    const uint8_t *ip = code;
+    int32_t *sp = stack;                // next free slot
+    uint16_t budget = VM_STEP_LIMIT;
+
+#define NEXT()      goto *DISPATCH[*ip]
+#define POP()       (*--sp)
+#define PUSH(v)     (*sp++ = (v))
+#define TOP         (sp[-1])
+#define BINARY(expr) { int32_t b = POP(); int32_t a = TOP; TOP = (expr); ip++; NEXT(); }
+#define JUMP()      { const uint8_t *target = code + (ip[1] | (ip[2] << 8)); \
+                      if (target <= ip && !--budget) { overruns++; return; } ip = target; NEXT(); }
+
+    NEXT();
+
+op_halt:    return;
+op_push8:   PUSH((int8_t)ip[1]); ip += 2; NEXT();
+op_push16:  PUSH((int16_t)(ip[1] | (ip[2] << 8))); ip += 3; NEXT();
+op_load:    PUSH(regs[ip[1]]); ip += 2; NEXT();
+op_store:   regs[ip[1]] = POP(); ip += 2; NEXT();
+op_dup:     { int32_t a = TOP; PUSH(a); ip++; NEXT(); }
+op_drop:    sp--; ip++; NEXT();
+op_swap:    { int32_t a = sp[-1]; sp[-1] = sp[-2]; sp[-2] = a; ip++; NEXT(); }
+op_over:    { int32_t a = sp[-2]; PUSH(a); ip++; NEXT(); }
+op_add:     BINARY((int32_t)((uint32_t)a + (uint32_t)b))
+op_sub:     BINARY((int32_t)((uint32_t)a - (uint32_t)b))
+op_mul:     BINARY((int32_t)((uint32_t)a * (uint32_t)b))
+op_div:     BINARY((b == 0 || (b == -1 && a == INT32_MIN)) ? 0 : a / b)
+op_mod:     BINARY((b == 0 || b == -1) ? 0 : a % b)
+op_mulfx:   BINARY((int32_t)(((int64_t)a * b) >> 8))
+op_neg:     TOP = (int32_t)(0u - (uint32_t)TOP); ip++; NEXT();
+op_abs:     TOP = TOP < 0 ? (int32_t)(0u - (uint32_t)TOP) : TOP; ip++; NEXT();
+op_and:     BINARY(a & b)
+op_or:      BINARY(a | b)
+op_xor:     BINARY(a ^ b)
+op_shl:     BINARY((int32_t)((uint32_t)a << (b & 31)))
+op_shr:     BINARY(a >> (b & 31))
+op_lt:      BINARY(a < b)
+op_gt:      BINARY(a > b)
+op_eq:      BINARY(a == b)
+op_not:     TOP = !TOP; ip++; NEXT();
+op_jmp:     JUMP()
+op_jz:      if (POP() == 0) JUMP() ip += 3; NEXT();
+op_jnz:     if (POP() != 0) JUMP() ip += 3; NEXT();
+op_sin:     TOP = Adafruit_NeoPixel::sine8((uint8_t)TOP); ip++; NEXT();
+op_rand:    TOP = TOP > 0 ? random(TOP) : 0; ip++; NEXT();
+op_time:    PUSH((int32_t)(Clock_Now() - startTime)); ip++; NEXT();
+op_frame:   PUSH((int32_t)frames); ip++; NEXT();
+op_btn:     PUSH(frameButtons); ip++; NEXT();
+op_hsv:     { int32_t v = POP(); int32_t s = POP(); int32_t h = POP();
+              pen = Color_HSV((uint16_t)h, clamp8(s), clamp8(v)); ip++; NEXT(); }
+op_rgb:     { int32_t b = POP(); int32_t g = POP(); int32_t r = POP();
+              pen = Color_Hex(((uint32_t)clamp8(r) << 16) | ((uint32_t)clamp8(g) << 8) | clamp8(b)); ip++; NEXT(); }
+op_set:     { int32_t y = POP(); int32_t x = POP(); plot(x, y); ip++; NEXT(); }
+op_fade:    Layer_Fade(LAYER_SCRIPT, clamp8(POP())); ip++; NEXT();
+op_clear:   Layer_Clear(LAYER_SCRIPT); ip++; NEXT();
+op_ring:    { int32_t r = POP(); int32_t y = POP(); int32_t x = POP(); drawRing(x, y, r); ip++; NEXT(); }
+op_line:    { int32_t y1 = POP(); int32_t x1 = POP(); int32_t y0 = POP(); int32_t x0 = POP();
+              drawLine(x0, y0, x1, y1); ip++; NEXT(); }
+
+#undef NEXT
+#undef POP
+#undef PUSH
+#undef TOP
+#undef BINARY
+#undef JUMP
+}
+
+// ==================== Program Storage ====================
+#define VM_NVS_NAMESPACE "luma-vm"
+#define VM_NVS_KEY       "prog"
+
+/**
+ * @brief Makes an image the running program, restarts it
+ *
+ */
+static void Vm_Install(const uint8_t *image, uint16_t length) {
+    memcpy(program, image, length);
+    programLength = length;
+    worstMicros = 0;
+    overruns = 0;
+    Vm_Start();
+}
+
+/**
+ * @brief Loads the program stored in flash, falls back to the built-in one if there is none or it fails to verify
+ * Runs from setup() - NVS allocates while it opens, the handle stays open for "vm end" and "vm reset"
+ */
+void Vm_Init() {
+    uint16_t length = 0;
+
+    if (!stored) stored = prefs.begin(VM_NVS_NAMESPACE, false);
+    if (stored) {
+        size_t size = prefs.getBytesLength(VM_NVS_KEY);
+        if (size && size <= VM_PROGRAM_MAX) length = prefs.getBytes(VM_NVS_KEY, program, size);
+    }
+
+    if (length && !Vm_Verify(program, length)) {
+        Vm_Install(program, length);
+    } else {
+        Vm_Install(BUILTIN, sizeof(BUILTIN));
+    }
+}
+
+// ==================== Interpreter Control ====================
+/**
+ * @brief Restarts the program from a clean state
+ *
+ */
+void Vm_Start() {
+    memset(regs, 0, sizeof(regs));
+    pen = RGB16_BLACK;
+    pendingButtons = 0;
+    frames = 0;
+    startTime = Clock_Now();
+    lastFrame = startTime - PERIOD_MS;      // first frame runs straight away
+    Layer_Clear(LAYER_SCRIPT);
+}
+
+/**
+ * @brief Queues button events for the next frame of the program
+ *
+ */
+void Vm_Button(uint8_t events) {
+    pendingButtons |= events;
+}
+
+/**
+ * @brief Runs one frame of the program into LAYER_SCRIPT when its period is due
+ *
+ */
+void Vm_Update() {
+    TRACE_SPAN("Vm_Update");
+    if (!programLength) return;                         // upload in progress
+    if (Clock_Now() - lastFrame < PERIOD_MS) return;
+    lastFrame = Clock_Now();
+
+    frameButtons = pendingButtons;
+    pendingButtons = 0;
+
+    unsigned long start = micros();
+    Vm_Execute();
+    unsigned long took = micros() - start;
+
+    lastMicros = took > 65535 ? 65535 : took;
+    if (lastMicros > worstMicros) worstMicros = lastMicros;
+    frames++;
+}
+
+// ==================== Console ====================
+/**
+ * @brief Parses two hex digits, -1 if they are not hex
+ *
+ */
+static int hexByte(const char *text) {
+    int value = 0;
+    for (int i = 0; i < 2; i++) {
+        char c = text[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')      value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+/**
+ * @brief Console command "vm"
+ *
+ *   vm                     status of the running program
+ *   vm begin               stops the program, the upload is written into the program buffer
+ *   vm put <offset> <hex>  up to VM_PUT_MAX bytes at offset (scripts/vm_asm.py prints these lines)
+ *   vm end                 verifies, stores in flash and starts the upload (built-in program if it fails)
+ *   vm reset               erases the stored program and goes back to the built-in one
+ */
+void Vm_Command(const char *args) {
+    static uint16_t uploadLength = 0;   // highest byte written by "vm put"
+
+    if (strcmp(args, "begin") == 0) {
+        programLength = 0;
+        uploadLength = 0;
+        Serial.println("vm: upload started");
+        return;
+    }
+
+    if (strncmp(args, "put ", 4) == 0) {
+        if (programLength) { Serial.println("vm: 'vm begin' first"); return; }
+
+        char *hex;
+        long offset = strtol(args + 4, &hex, 10);
+        while (*hex == ' ') hex++;
+
+        uint8_t count = strlen(hex) / 2;
+        if (offset < 0 || count == 0 || count > VM_PUT_MAX || offset + count > VM_PROGRAM_MAX) {
+            Serial.println("vm: bad put");
+            return;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            int value = hexByte(hex + i * 2);
+            if (value < 0) { Serial.println("vm: bad hex"); return; }
+            program[offset + i] = value;
+        }
+        if (offset + count > uploadLength) uploadLength = offset + count;
+        return;
+    }
+
+    if (strcmp(args, "end") == 0) {
+        if (programLength) { Serial.println("vm: 'vm begin' first"); return; }
+
+        const char *error = Vm_Verify(program, uploadLength);
+        if (error) {
+            Serial.print("vm: rejected - ");
+            Serial.println(error);
+            Vm_Init();      // back to whatever was stored before
+            return;
+        }
+
+        if (stored) prefs.putBytes(VM_NVS_KEY, program, uploadLength);
+        Vm_Install(program, uploadLength);
+        Serial.print("vm: stored ");
+        Serial.print(uploadLength);
+        Serial.println(" bytes");
+        return;
+    }
+
+    if (strcmp(args, "reset") == 0) {
+        if (stored) prefs.remove(VM_NVS_KEY);
+        Vm_Install(BUILTIN, sizeof(BUILTIN));
+        Serial.println("vm: built-in program");
+        return;
+    }
+
+    if (!programLength) {
+        Serial.println("vm: upload in progress");
+        return;
+    }
+    Serial.print("vm: ");
+    Serial.print(programLength);
+    Serial.print(" bytes | period ");
+    Serial.print(PERIOD_MS);
+    Serial.print(" ms | frame ");
+    Serial.print(lastMicros);
+    Serial.print(" us (worst ");
+    Serial.print(worstMicros);
+    Serial.print(") | overruns ");
+    Serial.println(overruns);
+}
+
+#ifdef LUMA_BENCH
+/**
+ * @brief Times the built-in program against the native flood step it reimplements
+ * Both draw one flood ring step per call, ~1s each
+ *
+ */
+void Vm_Benchmark() {
+    Vm_Install(BUILTIN, sizeof(BUILTIN));
+
+    uint32_t steps = 0;
+    unsigned long start = micros();
+    while (micros() - start < 1000000UL) {
+        Vm_Execute();
+        steps++;
+    }
+    unsigned long took = micros() - start;
+
+    Serial.print("[BENCH] vm flood: ");
+    Serial.print((uint32_t)((uint64_t)took * 1000 / steps));
+    Serial.println(" ns/step");
+
+#if LUMA_FEATURE_COLOR_FLOOD
+    ColorFloodContext flood;                            // own context, the device's flood is left alone
+    ColorFlood_Init(flood, LAYER_FLOOD);
+    steps = 0;
+    start = micros();
+    while (micros() - start < 1000000UL) {
+        if (steps % 17 == 0) ColorFlood_StartNew(flood);    // one flood lives WIDTH + HEIGHT + 1 steps, same as the program
+        ColorFlood_Step(flood, LAYER_FLOOD);
+        steps++;
+    }
+    took = micros() - start;
+
+    Serial.print("[BENCH] native flood: ");
+    Serial.print((uint32_t)((uint64_t)took * 1000 / steps));
+    Serial.println(" ns/step");
+    Layer_Clear(LAYER_FLOOD);
+#endif
+}
+#endif
+#endif
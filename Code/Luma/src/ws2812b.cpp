@@ -9,10 +9,13 @@
  * 
  */
 #include "ws2812b.h"
+#include "memstats.h"
 
 // Matrix Instance
 Adafruit_NeoPixel matrix(NUM_LEDS, DATA_PIN, NEO_GRB + NEO_KHZ800);
 
+static_assert(NUM_LEDS * 3 <= MEM_BUDGET_MATRIX, "NeoPixel buffer exceeds MEM_BUDGET_MATRIX - bigger panel, raise the budget on purpose");
+
 /**
  * @brief Convert 2D matrix coordinates to 1D pixel index
  * 